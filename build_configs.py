@@ -3,6 +3,10 @@ debug = ["-DCMAKE_BUILD_TYPE=Debug"]
 releasenolp = ["-DCMAKE_BUILD_TYPE=Release", "-DUSE_LP=NO"]
 debugnolp = ["-DCMAKE_BUILD_TYPE=Debug", "-DUSE_LP=NO"]
 minimal = ["-DCMAKE_BUILD_TYPE=Release", "-DDISABLE_PLUGINS_BY_DEFAULT=YES"]
+release64 = ["-DCMAKE_BUILD_TYPE=Release", "-DUSE_64_BIT_STATE_IDS=YES"]
+debug64 = ["-DCMAKE_BUILD_TYPE=Debug", "-DUSE_64_BIT_STATE_IDS=YES"]
+release64bins = ["-DCMAKE_BUILD_TYPE=Release", "-DUSE_64_BIT_STATE_BINS=YES"]
+debug64bins = ["-DCMAKE_BUILD_TYPE=Debug", "-DUSE_64_BIT_STATE_BINS=YES"]
 
 DEFAULT = "release"
 DEBUG = "debug"
@@ -0,0 +1,162 @@
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../../../src/search/algorithms/group_probing_int_hash_set.h"
+#include "../../../src/search/algorithms/int_hash_set.h"
+#include "../../../src/search/utils/hash.h"
+
+using namespace std;
+
+/*
+  Compare the hash sets used for duplicate detection in the state
+  registry. Unlike issue693/hash-microbenchmark and
+  ../hash-microbenchmark, which compare hash functions with
+  std::unordered_set, this benchmark uses the hash function of the planner
+  and varies the hash set. The driver (benchmark() and scramble()) is
+  taken from ../hash-microbenchmark, the more recent of the two, so that
+  we do not need the SpookyHash sources that issue693 includes.
+*/
+
+/*
+  The planner defines the global log in logging.cc, which depends on the
+  option parser, so we define it here.
+*/
+namespace utils {
+Log g_log;
+}
+
+/*
+  Like in the state registry, the keys in the hash set are indices into a
+  vector of data, and we use a placeholder key for looking up data that
+  is not stored in the hash set.
+*/
+static const int PROBE_KEY = numeric_limits<int>::max();
+
+struct Data {
+    vector<uint64_t> values;
+    uint64_t probe_value = 0;
+
+    uint64_t operator[](int key) const {
+        return key == PROBE_KEY ? probe_value : values[key];
+    }
+};
+
+struct DataHash {
+    const Data &data;
+    explicit DataHash(const Data &data) : data(data) {}
+    unsigned int operator()(int key) const {
+        return utils::get_hash32(data[key]);
+    }
+};
+
+struct DataEqual {
+    const Data &data;
+    explicit DataEqual(const Data &data) : data(data) {}
+    bool operator()(int lhs, int rhs) const {
+        return data[lhs] == data[rhs];
+    }
+};
+
+using HopscotchSet = int_hash_set::IntHashSet<DataHash, DataEqual>;
+using GroupProbingSet = int_hash_set::GroupProbingIntHashSet<DataHash, DataEqual>;
+
+
+static void benchmark(const string &desc, int num_calls,
+                      const function<void()> &func) {
+    cout << "Running " << desc << " " << num_calls << " times:" << flush;
+
+    clock_t start = clock();
+    for (int j = 0; j < num_calls; ++j)
+        func();
+    clock_t end = clock();
+    double duration = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+    cout << " " << duration << "s" << endl;
+}
+
+
+static uint64_t scramble(uint64_t i) {
+    return (0xdeadbeefcafef00dULL * i) ^ 0xfeedcafe;
+}
+
+
+/*
+  Insert all values into the hash set, looking each one up first as the
+  state registry does for every generated state.
+*/
+template<typename HashSet>
+static void insert_all(HashSet &s, Data &data) {
+    for (size_t i = 0; i < data.values.size(); ++i) {
+        data.probe_value = data.values[i];
+        if (s.find(PROBE_KEY) == -1) {
+            s.insert(i);
+        }
+    }
+}
+
+template<typename HashSet>
+static int find_all(const HashSet &s, Data &data, int num_passes,
+                    uint64_t offset) {
+    int num_found = 0;
+    for (int pass = 0; pass < num_passes; ++pass) {
+        for (size_t i = 0; i < data.values.size(); ++i) {
+            data.probe_value = data.values[i] + offset;
+            num_found += (s.find(PROBE_KEY) != -1);
+        }
+    }
+    return num_found;
+}
+
+template<typename HashSet>
+static void run_benchmarks(const string &name, Data &data,
+                           int num_calls, int num_read_passes) {
+    benchmark("insert with " + name, num_calls,
+              [&]() {
+                  HashSet s{DataHash(data), DataEqual(data)};
+                  insert_all(s, data);
+              });
+    HashSet s{DataHash(data), DataEqual(data)};
+    insert_all(s, data);
+    // Print the number of found keys so that the lookups are not optimized away.
+    int num_found = 0;
+    benchmark("find present keys with " + name, num_calls,
+              [&]() {
+                  num_found += find_all(s, data, num_read_passes, 0);
+              });
+    benchmark("find absent keys with " + name, num_calls,
+              [&]() {
+                  num_found += find_all(s, data, num_read_passes, 1);
+              });
+    cout << "Found " << num_found << " keys" << endl;
+    s.print_statistics();
+}
+
+
+int main(int, char **) {
+    const int REPETITIONS = 2;
+    const int NUM_CALLS = 1;
+    const int NUM_READ_PASSES = 5;
+
+    for (int num_values : {100000, 10000000}) {
+        Data data;
+        /* Only use even values so that looking up value + 1 misses. About
+           a third of the values are duplicates. */
+        for (int i = 0; i < num_values; ++i) {
+            data.values.push_back(scramble(i % (num_values * 2 / 3)) * 2);
+        }
+        cout << num_values << " values" << endl << endl;
+        for (int i = 0; i < REPETITIONS; ++i) {
+            run_benchmarks<HopscotchSet>(
+                "IntHashSet", data, NUM_CALLS, NUM_READ_PASSES);
+            cout << endl;
+            run_benchmarks<GroupProbingSet>(
+                "GroupProbingIntHashSet", data, NUM_CALLS, NUM_READ_PASSES);
+            cout << endl;
+        }
+    }
+
+    return 0;
+}
@@ -137,6 +137,40 @@ def configs_optimal_extended():
         "pdb": [
             "--search",
             "astar(pdb())"],
+        "hda_astar_lmcut": [
+            "--search",
+            "hda_astar(lmcut(), num_threads=2)"],
+        "hda_blind": [
+            "--search",
+            "hda(tiebreaking([sum([g(), blind()]), blind()]),"
+            "f_eval=sum([g(), blind()]), num_threads=3)"],
+        "hda_astar_blind_many_threads": [
+            "--search",
+            "hda_astar(blind(), num_threads=8)"],
+        "astar_lmcut_zobrist": [
+            "--search",
+            "astar(lmcut(), state_hashing=zobrist)"],
+        "astar_lmcut_no_parents": [
+            "--search",
+            "astar(lmcut(), store_parents=false)"],
+        "astar_lmcut_tree_compression": [
+            "--search",
+            "astar(lmcut(), state_compression=tree)"],
+        "astar_lmcut_spill": [
+            "--search",
+            "astar(lmcut(), spill_directory=., spill_search_nodes=true)"],
+        "bfhs_lmcut": [
+            "--search",
+            "bfhs(lmcut())"],
+        "idastar_lmcut": [
+            "--search",
+            "idastar(lmcut())"],
+        "bidirectional_blind": [
+            "--search",
+            "bidirectional(blind())"],
+        "bidirectional_lmcut": [
+            "--search",
+            "bidirectional(lmcut())"],
     }
 
 
@@ -199,6 +233,30 @@ def configs_satisficing_extended():
             "--search",
             "eager(pareto([sum([g(), h]), h]), reopen_closed=true,"
             "f_eval=sum([g(), h]))"],
+        "rwastar_ff": [
+            "--search",
+            "rwastar(ff())"],
+        "focal_lmcut_ff": [
+            "--search",
+            "focal(lmcut(), tiebreaking([ff(), g()]), w=1.2)"],
+        "iw_2": [
+            "--search",
+            "iw(width=2)"],
+        "eager_greedy_novelty_ff": [
+            "--search",
+            "eager_greedy([novelty(width=2, partition=ff()), ff()])"],
+        "eager_greedy_ff_bitstate": [
+            "--search",
+            "eager_greedy([ff()], bitstate_mb=1)"],
+        "lazy_greedy_ff_bitstate": [
+            "--search",
+            "lazy_greedy([ff()], preferred=[ff()], bitstate_mb=1)"],
+        "lazy_parallel_ff": [
+            "--search",
+            "lazy_parallel([ff()], preferred=[ff()], num_threads=4)"],
+        "eager_multi_queue_ff": [
+            "--search",
+            "eager(multi_queue(ff(), num_threads=4))"],
     }
 
 
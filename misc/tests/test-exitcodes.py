@@ -121,6 +121,8 @@ SEARCH_TESTS = [
         defaultdict(lambda: returncodes.SEARCH_UNSUPPORTED)),
     ("cond-eff", [], MERGE_AND_SHRINK,
         defaultdict(lambda: returncodes.SUCCESS)),
+    ("cond-eff", [], "astar(add(), store_parents=false)",
+        defaultdict(lambda: returncodes.SEARCH_UNSUPPORTED)),
     # We cannot set/enforce memory limits on Windows/macOS and thus expect
     # DRIVER_UNSUPPORTED as exit code in those cases.
     ("large", ["--search-memory-limit", "100M"], MERGE_AND_SHRINK,
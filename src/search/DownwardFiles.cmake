@@ -50,7 +50,11 @@ fast_downward_plugin(
 
         abstract_task
         axioms
+        bitstate_state_registry
         command_line
+        compressed_state_registry
+        concurrent_per_state_information
+        concurrent_state_registry
         evaluation_context
         evaluation_result
         evaluator
@@ -80,7 +84,7 @@ fast_downward_plugin(
         task_id
         task_proxy
 
-    DEPENDS CAUSAL_GRAPH INT_HASH_SET INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDS CAUSAL_GRAPH CONCURRENT_SEGMENTED_VECTOR INT_HASH_SET INT_PACKER MAPPED_FILE_ARENA ORDERED_SET SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR TASK_PROPERTIES
     CORE_PLUGIN
 )
 
@@ -141,6 +145,13 @@ fast_downward_plugin(
         open_lists/best_first_open_list
 )
 
+fast_downward_plugin(
+    NAME BUCKET_ASTAR_OPEN_LIST
+    HELP "Open list with f and h buckets for A*"
+    SOURCES
+        open_lists/bucket_astar_open_list
+)
+
 fast_downward_plugin(
     NAME EPSILON_GREEDY_OPEN_LIST
     HELP "Open list that chooses an entry randomly with probability epsilon"
@@ -148,6 +159,14 @@ fast_downward_plugin(
         open_lists/epsilon_greedy_open_list
 )
 
+fast_downward_plugin(
+    NAME MULTI_QUEUE_OPEN_LIST
+    HELP "Relaxed open list that supports concurrent insertions and removals"
+    SOURCES
+        open_lists/multi_queue_open_list
+    DEPENDS MULTI_QUEUE
+)
+
 fast_downward_plugin(
     NAME PARETO_OPEN_LIST
     HELP "Pareto open list"
@@ -155,11 +174,20 @@ fast_downward_plugin(
         open_lists/pareto_open_list
 )
 
+fast_downward_plugin(
+    NAME EVALUATOR_KEY
+    HELP "Fixed-size keys with evaluator values for open lists"
+    SOURCES
+        open_lists/evaluator_key
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME TIEBREAKING_OPEN_LIST
     HELP "Tiebreaking open list"
     SOURCES
         open_lists/tiebreaking_open_list
+    DEPENDS EVALUATOR_KEY
 )
 
 fast_downward_plugin(
@@ -167,6 +195,15 @@ fast_downward_plugin(
     HELP "Type-based open list"
     SOURCES
         open_lists/type_based_open_list
+    DEPENDS EVALUATOR_KEY
+)
+
+fast_downward_plugin(
+    NAME CONCURRENT_SEGMENTED_VECTOR
+    HELP "Variant of SegmentedArrayVector that supports concurrent writes"
+    SOURCES
+        algorithms/concurrent_segmented_vector
+    DEPENDENCY_ONLY
 )
 
 fast_downward_plugin(
@@ -190,6 +227,7 @@ fast_downward_plugin(
     HELP "Hash set storing non-negative integers"
     SOURCES
         algorithms/int_hash_set
+        algorithms/group_probing_int_hash_set
     DEPENDENCY_ONLY
 )
 
@@ -201,6 +239,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME MAPPED_FILE_ARENA
+    HELP "Allocator that places data in a memory-mapped temporary file"
+    SOURCES
+        algorithms/mapped_file_arena
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME MAX_CLIQUES
     HELP "Implementation of the Max Cliques algorithm by Tomita et al."
@@ -209,6 +255,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME MULTI_QUEUE
+    HELP "Relaxed concurrent priority queue made of several locked heaps"
+    SOURCES
+        algorithms/multi_queue
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME PRIORITY_QUEUES
     HELP "Three implementations of priority queue: HeapQueue, BucketQueue and AdaptiveQueue"
@@ -350,7 +404,7 @@ fast_downward_plugin(
     HELP "Basic classes used for all search engines"
     SOURCES
         search_engines/search_common
-    DEPENDS ALTERNATION_OPEN_LIST G_EVALUATOR BEST_FIRST_OPEN_LIST SUM_EVALUATOR TIEBREAKING_OPEN_LIST WEIGHTED_EVALUATOR
+    DEPENDS ALTERNATION_OPEN_LIST BUCKET_ASTAR_OPEN_LIST G_EVALUATOR BEST_FIRST_OPEN_LIST SUM_EVALUATOR WEIGHTED_EVALUATOR
     DEPENDENCY_ONLY
 )
 
@@ -419,12 +473,93 @@ fast_downward_plugin(
     DEPENDS LAZY_SEARCH SEARCH_COMMON
 )
 
+fast_downward_plugin(
+    NAME PLUGIN_LAZY_PARALLEL
+    HELP "K-parallel greedy best-first search with deferred evaluation (lazy)"
+    SOURCES
+        search_engines/plugin_lazy_parallel
+    DEPENDS LAZY_PARALLEL_SEARCH SEARCH_COMMON
+)
+
+fast_downward_plugin(
+    NAME BREADTH_FIRST_HEURISTIC_SEARCH
+    HELP "Breadth-first heuristic search with divide-and-conquer plan reconstruction"
+    SOURCES
+        search_engines/breadth_first_heuristic_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
+fast_downward_plugin(
+    NAME IDASTAR_SEARCH
+    HELP "Iterative-deepening A* with a bounded transposition table"
+    SOURCES
+        search_engines/idastar_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
+fast_downward_plugin(
+    NAME BIDIRECTIONAL_SEARCH
+    HELP "Bidirectional search meeting in the middle"
+    SOURCES
+        search_engines/bidirectional_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
+fast_downward_plugin(
+    NAME RESTARTING_WASTAR_SEARCH
+    HELP "Restarting weighted A* search"
+    SOURCES
+        search_engines/restarting_wastar_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
+fast_downward_plugin(
+    NAME FOCAL_SEARCH
+    HELP "Focal search for bounded-suboptimal planning"
+    SOURCES
+        search_engines/focal_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
+fast_downward_plugin(
+    NAME IW_SEARCH
+    HELP "Iterated width search"
+    SOURCES
+        search_engines/iw_search
+    DEPENDS NOVELTY_TABLE SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME ENFORCED_HILL_CLIMBING_SEARCH
     HELP "Lazy enforced hill-climbing search algorithm"
     SOURCES
         search_engines/enforced_hill_climbing_search
-    DEPENDS G_EVALUATOR ORDERED_SET PREF_EVALUATOR SEARCH_COMMON SUCCESSOR_GENERATOR
+    DEPENDS G_EVALUATOR ORDERED_SET PREF_EVALUATOR SEARCH_COMMON SUCCESSOR_GENERATOR TIEBREAKING_OPEN_LIST
+)
+
+fast_downward_plugin(
+    NAME HDA_SEARCH
+    HELP "Hash-distributed parallel best-first search algorithm"
+    SOURCES
+        search_engines/hda_search
+    DEPENDS ORDERED_SET SEARCH_COMMON SUCCESSOR_GENERATOR
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME PLUGIN_HDA
+    HELP "Hash-distributed parallel best-first search"
+    SOURCES
+        search_engines/plugin_hda
+    DEPENDS HDA_SEARCH
+)
+
+fast_downward_plugin(
+    NAME PLUGIN_HDA_ASTAR
+    HELP "Hash-distributed parallel A* search (HDA*)"
+    SOURCES
+        search_engines/plugin_hda_astar
+    DEPENDS HDA_SEARCH
 )
 
 fast_downward_plugin(
@@ -443,6 +578,15 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME LAZY_PARALLEL_SEARCH
+    HELP "K-parallel lazy search algorithm"
+    SOURCES
+        search_engines/lazy_parallel_search
+    DEPENDS LAZY_SEARCH
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME LP_SOLVER
     HELP "Interface to an LP solver"
@@ -541,6 +685,14 @@ fast_downward_plugin(
     DEPENDS PRIORITY_QUEUES RELAXATION_HEURISTIC
 )
 
+fast_downward_plugin(
+    NAME NOVELTY_HEURISTIC
+    HELP "The novelty heuristic"
+    SOURCES
+        heuristics/novelty_heuristic
+    DEPENDS NOVELTY_TABLE
+)
+
 fast_downward_plugin(
     NAME CORE_TASKS
     HELP "Core task transformations"
@@ -571,6 +723,15 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME NOVELTY_TABLE
+    HELP "Tables of seen facts and fact pairs for novelty"
+    SOURCES
+        task_utils/novelty_table
+    DEPENDS DYNAMIC_BITSET
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME SAMPLING
     HELP "Sampling"
@@ -0,0 +1,178 @@
+#ifndef ALGORITHMS_CONCURRENT_SEGMENTED_VECTOR_H
+#define ALGORITHMS_CONCURRENT_SEGMENTED_VECTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+/*
+  ConcurrentSegmentedArrayVector is a variant of SegmentedArrayVector (see
+  segmented_vector.h) that can be written and read by several threads at the
+  same time. Instead of appending arrays at the end, writers fill the arrays
+  at indices they reserved beforehand (e.g., with an atomic counter), so
+  different threads can write different arrays concurrently. Looking up an
+  array never blocks; only adding a segment takes a lock.
+
+  A thread may only read an array if writing it happened before the read,
+  e.g., because the writer passed the index on through a mutex or an atomic
+  variable. In the typical use case, the index is only published after the
+  array has been written, so this holds automatically.
+
+  Alternatively, get_or_add() initializes all arrays of a segment with a
+  default array when the segment is added. Afterwards, each array can be
+  read and modified without further synchronization as long as every array
+  is only accessed by one thread at a time.
+
+  Since readers access the table of segments without locking, the table
+  cannot be reallocated in place. When it is full, we copy it into a table
+  of twice the size and keep the old tables alive until the vector is
+  destroyed, because concurrent readers may still use them. Their combined
+  size is smaller than the size of the current table.
+*/
+
+// For documentation on classes relevant to storing and working with registered
+// states see the file state_registry.h.
+
+namespace segmented_vector {
+template<class Element, class Allocator = std::allocator<Element>>
+class ConcurrentSegmentedArrayVector {
+    typedef typename Allocator::template rebind<Element>::other ElementAllocator;
+    // We never destroy individual arrays since we do not track which ones exist.
+    static_assert(std::is_trivially_destructible<Element>::value,
+                  "ConcurrentSegmentedArrayVector requires trivially "
+                  "destructible elements");
+    static const size_t SEGMENT_BYTES = 8192;
+    static const size_t INITIAL_TABLE_SIZE = 64;
+
+    const size_t elements_per_array;
+    const size_t arrays_per_segment;
+    const size_t elements_per_segment;
+
+    ElementAllocator element_allocator;
+
+    // Guards adding segments and growing the table of segments.
+    std::mutex segment_mutex;
+    // All tables that were used so far. The last one is the current one.
+    std::vector<std::unique_ptr<std::atomic<Element *>[]>> segment_tables;
+    size_t table_size;
+    std::atomic<std::atomic<Element *> *> segments;
+    std::atomic<size_t> num_segments;
+
+    size_t get_segment(size_t index) const {
+        return index / arrays_per_segment;
+    }
+
+    size_t get_offset(size_t index) const {
+        return (index % arrays_per_segment) * elements_per_array;
+    }
+
+    std::atomic<Element *> *add_table(size_t size) {
+        segment_tables.emplace_back(new std::atomic<Element *>[size]);
+        table_size = size;
+        return segment_tables.back().get();
+    }
+
+    /*
+      Must only be called while holding segment_mutex. If default_array is
+      given, all arrays of the new segment are initialized with it.
+    */
+    void add_segment(const Element *default_array = nullptr) {
+        size_t segment = num_segments.load(std::memory_order_relaxed);
+        std::atomic<Element *> *table = segments.load(std::memory_order_relaxed);
+        if (segment == table_size) {
+            std::atomic<Element *> *new_table = add_table(2 * table_size);
+            for (size_t i = 0; i < segment; ++i) {
+                new_table[i].store(table[i].load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+            }
+            table = new_table;
+            segments.store(table, std::memory_order_release);
+        }
+        Element *new_segment = element_allocator.allocate(elements_per_segment);
+        if (default_array) {
+            for (size_t i = 0; i < elements_per_segment; ++i) {
+                element_allocator.construct(
+                    new_segment + i, default_array[i % elements_per_array]);
+            }
+        }
+        table[segment].store(new_segment, std::memory_order_relaxed);
+        num_segments.store(segment + 1, std::memory_order_release);
+    }
+
+    // No implementation to forbid copies and assignment
+    ConcurrentSegmentedArrayVector(const ConcurrentSegmentedArrayVector<Element> &);
+    ConcurrentSegmentedArrayVector &operator=(const ConcurrentSegmentedArrayVector<Element> &);
+public:
+    explicit ConcurrentSegmentedArrayVector(size_t elements_per_array_)
+        : elements_per_array(elements_per_array_),
+          arrays_per_segment(
+              std::max(SEGMENT_BYTES / (elements_per_array * sizeof(Element)), size_t(1))),
+          elements_per_segment(elements_per_array * arrays_per_segment),
+          table_size(0),
+          segments(nullptr),
+          num_segments(0) {
+        segments.store(add_table(INITIAL_TABLE_SIZE));
+    }
+
+    ~ConcurrentSegmentedArrayVector() {
+        std::atomic<Element *> *table = segments.load();
+        for (size_t i = 0; i < num_segments.load(); ++i) {
+            element_allocator.deallocate(table[i].load(), elements_per_segment);
+        }
+    }
+
+    Element *operator[](size_t index) {
+        assert(get_segment(index) < num_segments.load());
+        std::atomic<Element *> *table = segments.load(std::memory_order_acquire);
+        return table[get_segment(index)].load(std::memory_order_relaxed) +
+               get_offset(index);
+    }
+
+    const Element *operator[](size_t index) const {
+        assert(get_segment(index) < num_segments.load());
+        std::atomic<Element *> *table = segments.load(std::memory_order_acquire);
+        return table[get_segment(index)].load(std::memory_order_relaxed) +
+               get_offset(index);
+    }
+
+    /*
+      Copy the given array to the given index, allocating memory for it if
+      necessary. Must not be called twice for the same index.
+    */
+    void set(size_t index, const Element *entry) {
+        size_t segment = get_segment(index);
+        if (segment >= num_segments.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(segment_mutex);
+            while (segment >= num_segments.load(std::memory_order_relaxed)) {
+                add_segment();
+            }
+        }
+        Element *dest = (*this)[index];
+        for (size_t i = 0; i < elements_per_array; ++i)
+            element_allocator.construct(dest++, *entry++);
+    }
+
+    /*
+      Return the array at the given index. If its segment does not exist
+      yet, add it (and all segments before it) and initialize their arrays
+      with copies of default_array. All callers must use the same
+      default_array, and the vector must not be used with set().
+    */
+    Element *get_or_add(size_t index, const Element *default_array) {
+        size_t segment = get_segment(index);
+        if (segment >= num_segments.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(segment_mutex);
+            while (segment >= num_segments.load(std::memory_order_relaxed)) {
+                add_segment(default_array);
+            }
+        }
+        return (*this)[index];
+    }
+};
+}
+
+#endif
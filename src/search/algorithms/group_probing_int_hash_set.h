@@ -0,0 +1,296 @@
+#ifndef ALGORITHMS_GROUP_PROBING_INT_HASH_SET_H
+#define ALGORITHMS_GROUP_PROBING_INT_HASH_SET_H
+
+#include "int_hash_set.h"
+
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace int_hash_set {
+/*
+  Hash set for storing non-negative integer keys with the same interface
+  as IntHashSet, but a different memory layout.
+
+  Usage and limitations on keys are as for IntHashSet.
+
+  Implementation:
+
+  The buckets are partitioned into groups of GROUP_SIZE = 16 consecutive
+  buckets. In addition to the keys, we store one control byte per bucket,
+  which is either EMPTY or a 7-bit fingerprint of the hash of the key in
+  the bucket. The remaining bits of the hash choose the first group that
+  we probe for a key. We probe groups in triangular order (group g, g + 1,
+  g + 3, g + 6, ...), which visits all groups because the number of groups
+  is a power of 2.
+
+  For each probed group, we compare all its control bytes to the
+  fingerprint of the key at once (with one SSE2 instruction if available)
+  and only call the equality tester for matching buckets. Since each key
+  only falls into the first group with free buckets and we grow the table
+  at a load factor of 7/8, most lookups touch a single group, i.e., 16
+  bytes of control data and the keys of the matching buckets.
+
+  Compared to IntHashSet, which stores a 4-byte hash value with every key,
+  this uses 5 instead of 8 bytes per bucket with the default key type.
+  Since hash values are not stored, resizing the set calls the hasher for
+  every key again.
+
+  The maximum capacity is the same as for IntHashSet (2^27 groups of 16
+  buckets for 32-bit hash values). Since only 25 of the 32 hash bits are
+  left after the fingerprint, larger tables also use fingerprint bits for
+  choosing the group.
+*/
+template<typename Hasher, typename Equal,
+         typename Key = KeyType, typename Hash = HashType>
+class GroupProbingIntHashSet {
+    static_assert(std::numeric_limits<Key>::is_signed,
+                  "Key must be a signed integer type");
+    static_assert(!std::numeric_limits<Hash>::is_signed,
+                  "Hash must be an unsigned integer type");
+
+    static const int GROUP_SIZE = 16;
+    static const int FINGERPRINT_BITS = 7;
+    static const int8_t EMPTY = -128;
+    /*
+      Like IntHashSet, we support at most 2^31 buckets with 32-bit hash
+      values (see enlarge()).
+    */
+    static const size_t MAX_GROUPS =
+        (std::numeric_limits<Hash>::max() < std::numeric_limits<size_t>::max() ?
+         static_cast<size_t>(std::numeric_limits<Hash>::max()) :
+         std::numeric_limits<size_t>::max()) / GROUP_SIZE;
+
+    Hasher hasher;
+    Equal equal;
+    std::vector<int8_t> control;
+    std::vector<Key> keys;
+    size_t num_entries;
+    int num_resizes;
+
+    size_t capacity() const {
+        return keys.size();
+    }
+
+    size_t get_num_groups() const {
+        return capacity() / GROUP_SIZE;
+    }
+
+    size_t get_group(Hash hash) const {
+        // Verify that the number of groups is a power of 2.
+        assert((get_num_groups() & (get_num_groups() - 1)) == 0);
+        /*
+          We rotate the fingerprint bits to the top, so that very large
+          tables can use them for choosing the group. This only makes the
+          fingerprints of such tables less selective.
+        */
+        const int hash_bits = std::numeric_limits<Hash>::digits;
+        Hash rotated_hash = (hash >> FINGERPRINT_BITS) |
+            (hash << (hash_bits - FINGERPRINT_BITS));
+        return rotated_hash & (get_num_groups() - 1);
+    }
+
+    static int8_t get_fingerprint(Hash hash) {
+        return hash & ((1 << FINGERPRINT_BITS) - 1);
+    }
+
+    /*
+      Return a bitmask whose i-th bit is set iff the i-th control byte of
+      the group starting at the given bucket is equal to value.
+    */
+    unsigned int match(size_t group_start, int8_t value) const {
+        const int8_t *group_control = &control[group_start];
+#ifdef __SSE2__
+        __m128i group_bytes = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(group_control));
+        return _mm_movemask_epi8(
+            _mm_cmpeq_epi8(group_bytes, _mm_set1_epi8(value)));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < GROUP_SIZE; ++i) {
+            if (group_control[i] == value) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    static int get_lowest_bit_index(unsigned int mask) {
+        assert(mask != 0);
+#ifdef __GNUC__
+        return __builtin_ctz(mask);
+#else
+        int index = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    void rehash(size_t new_capacity) {
+        assert(new_capacity >= static_cast<size_t>(GROUP_SIZE));
+        std::vector<Key> old_keys = std::move(keys);
+        std::vector<int8_t> old_control = std::move(control);
+        keys.assign(new_capacity, Key(-1));
+        control.assign(new_capacity, EMPTY);
+        for (size_t i = 0; i < old_keys.size(); ++i) {
+            if (old_control[i] != EMPTY) {
+                insert_new_key(old_keys[i], hasher(old_keys[i]));
+            }
+        }
+        ++num_resizes;
+    }
+
+    void enlarge() {
+        if (get_num_groups() > MAX_GROUPS / 2) {
+            std::cerr << "GroupProbingIntHashSet surpassed maximum capacity."
+                " This means you either use it for high-memory"
+                " applications for which it was not designed, or there"
+                " is an unexpectedly high number of hash collisions"
+                " that should be investigated. Aborting."
+                      << std::endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        rehash(capacity() * 2);
+    }
+
+    // Store a key that is not contained in the hash set yet.
+    void insert_new_key(Key key, Hash hash) {
+        size_t group = get_group(hash);
+        for (size_t step = 1;; ++step) {
+            size_t group_start = group * GROUP_SIZE;
+            unsigned int free_buckets = match(group_start, EMPTY);
+            if (free_buckets) {
+                size_t index = group_start + get_lowest_bit_index(free_buckets);
+                control[index] = get_fingerprint(hash);
+                keys[index] = key;
+                return;
+            }
+            group = (group + step) & (get_num_groups() - 1);
+        }
+    }
+
+    Key find_equal_key(Key key, Hash hash) const {
+        assert(hasher(key) == hash);
+        int8_t fingerprint = get_fingerprint(hash);
+        size_t group = get_group(hash);
+        for (size_t step = 1;; ++step) {
+            size_t group_start = group * GROUP_SIZE;
+            for (unsigned int candidates = match(group_start, fingerprint);
+                 candidates; candidates &= candidates - 1) {
+                size_t index = group_start + get_lowest_bit_index(candidates);
+                if (equal(keys[index], key)) {
+                    return keys[index];
+                }
+            }
+            /* Keys are only stored in a later group if all earlier groups
+               were full, so we can stop at the first free bucket. */
+            if (match(group_start, EMPTY)) {
+                return -1;
+            }
+            group = (group + step) & (get_num_groups() - 1);
+        }
+    }
+
+public:
+    GroupProbingIntHashSet(const Hasher &hasher, const Equal &equal)
+        : hasher(hasher),
+          equal(equal),
+          control(GROUP_SIZE, EMPTY),
+          keys(GROUP_SIZE, Key(-1)),
+          num_entries(0),
+          num_resizes(0) {
+    }
+
+    size_t size() const {
+        return num_entries;
+    }
+
+    // See IntHashSet::insert(key).
+    std::pair<Key, bool> insert(Key key) {
+        assert(key >= 0);
+        return insert(key, hasher(key));
+    }
+
+    // See IntHashSet::find(key).
+    Key find(Key key) const {
+        assert(key >= 0);
+        return find_equal_key(key, hasher(key));
+    }
+
+    // Like find(key), but with a given hash value equal to hasher(key).
+    Key find(Key key, Hash hash) const {
+        assert(key >= 0);
+        return find_equal_key(key, hash);
+    }
+
+    // See IntHashSet::insert(key, hash).
+    std::pair<Key, bool> insert(Key key, Hash hash) {
+        assert(hasher(key) == hash);
+        Key equal_key = find_equal_key(key, hash);
+        if (equal_key != -1) {
+            return std::make_pair(equal_key, false);
+        }
+        // Keep the load factor at most 7/8.
+        if ((num_entries + 1) * 8 > capacity() * 7) {
+            enlarge();
+        }
+        insert_new_key(key, hash);
+        ++num_entries;
+        return std::make_pair(key, true);
+    }
+
+    void dump() const {
+        size_t num_buckets = capacity();
+        utils::g_log << "[";
+        for (size_t i = 0; i < num_buckets; ++i) {
+            if (control[i] != EMPTY) {
+                utils::g_log << keys[i];
+            } else {
+                utils::g_log << "_";
+            }
+            if (i < num_buckets - 1) {
+                utils::g_log << ", ";
+            }
+        }
+        utils::g_log << "]" << std::endl;
+    }
+
+    void print_statistics() const {
+        size_t num_buckets = capacity();
+        assert(num_buckets != 0);
+        utils::g_log << "Int hash set load factor: " << num_entries << "/"
+                     << num_buckets << " = "
+                     << static_cast<double>(num_entries) / num_buckets
+                     << std::endl;
+        utils::g_log << "Int hash set resizes: " << num_resizes << std::endl;
+    }
+};
+
+template<typename Hasher, typename Equal, typename Key, typename Hash>
+const int GroupProbingIntHashSet<Hasher, Equal, Key, Hash>::GROUP_SIZE;
+
+template<typename Hasher, typename Equal, typename Key, typename Hash>
+const int GroupProbingIntHashSet<Hasher, Equal, Key, Hash>::FINGERPRINT_BITS;
+
+template<typename Hasher, typename Equal, typename Key, typename Hash>
+const int8_t GroupProbingIntHashSet<Hasher, Equal, Key, Hash>::EMPTY;
+
+template<typename Hasher, typename Equal, typename Key, typename Hash>
+const size_t GroupProbingIntHashSet<Hasher, Equal, Key, Hash>::MAX_GROUPS;
+}
+
+#endif
@@ -18,9 +18,9 @@ namespace int_hash_set {
   Hash set for storing non-negative integer keys.
 
   Compared to unordered_set<int> in the standard library, this
-  implementation is much more memory-efficient. It requires 8 bytes
-  per bucket, so roughly 12-16 bytes per entry with typical load
-  factors.
+  implementation is much more memory-efficient. With the default key
+  and hash types, it requires 8 bytes per bucket, so roughly 12-16
+  bytes per entry with typical load factors.
 
   Usage:
 
@@ -32,19 +32,19 @@ namespace int_hash_set {
 
   Limitations:
 
-  We use 32-bit (signed and unsigned) integers instead of larger data
-  types for keys and hashes to save memory.
+  By default, we use 32-bit (signed and unsigned) integers instead of
+  larger data types for keys and hashes to save memory. Other integer
+  types can be passed as template arguments if more keys are needed.
 
-  Consequently, the range of valid keys is [0, 2^31 - 1]. This range
-  could be extended to [0, 2^32 - 2] without using more memory by
-  using unsigned integers for the keys and a different designated
-  value for empty buckets (currently we use -1 for this).
+  Consequently, the range of valid keys is [0, 2^31 - 1] by default.
+  This range could be extended to [0, 2^32 - 2] without using more
+  memory by using unsigned integers for the keys and a different
+  designated value for empty buckets (currently we use -1 for this).
 
-  The maximum capacity (i.e., number of buckets) is 2^30 because we
-  use a signed integer to store it, we grow the hash set by doubling
-  its capacity, and the next larger power of 2 (2^31) is too big for
-  an int. The maximum capacity could be increased by storing the
-  number of buckets in a larger data type.
+  The maximum capacity (i.e., number of buckets) is half the number of
+  distinct hash values (2^31 by default) because we grow the hash set
+  by doubling its capacity and choose buckets by the low bits of the
+  hash.
 
   Note on hash functions:
 
@@ -75,24 +75,33 @@ using HashType = unsigned int;
 static_assert(sizeof(KeyType) == 4, "KeyType does not use 4 bytes");
 static_assert(sizeof(HashType) == 4, "HashType does not use 4 bytes");
 
-template<typename Hasher, typename Equal>
+template<typename Hasher, typename Equal,
+         typename Key = KeyType, typename Hash = HashType>
 class IntHashSet {
+    static_assert(std::numeric_limits<Key>::is_signed,
+                  "Key must be a signed integer type");
+    static_assert(!std::numeric_limits<Hash>::is_signed,
+                  "Hash must be an unsigned integer type");
+
     // Max distance from the ideal bucket to the actual bucket for each key.
     static const int MAX_DISTANCE = 32;
-    static const unsigned int MAX_BUCKETS = std::numeric_limits<unsigned int>::max();
+    static const size_t MAX_BUCKETS =
+        std::numeric_limits<Hash>::max() < std::numeric_limits<size_t>::max() ?
+        static_cast<size_t>(std::numeric_limits<Hash>::max()) :
+        std::numeric_limits<size_t>::max();
 
     struct Bucket {
-        KeyType key;
-        HashType hash;
+        Key key;
+        Hash hash;
 
-        static const KeyType empty_bucket_key = -1;
+        static const Key empty_bucket_key = -1;
 
         Bucket()
             : key(empty_bucket_key),
               hash(0) {
         }
 
-        Bucket(KeyType key, HashType hash)
+        Bucket(Key key, Hash hash)
             : key(key),
               hash(hash) {
         }
@@ -105,16 +114,16 @@ class IntHashSet {
     Hasher hasher;
     Equal equal;
     std::vector<Bucket> buckets;
-    int num_entries;
+    size_t num_entries;
     int num_resizes;
 
-    int capacity() const {
+    size_t capacity() const {
         return buckets.size();
     }
 
-    void rehash(int new_capacity) {
+    void rehash(size_t new_capacity) {
         assert(new_capacity >= 1);
-        int num_entries_before = num_entries;
+        size_t num_entries_before = num_entries;
         std::vector<Bucket> old_buckets = std::move(buckets);
         assert(buckets.empty());
         num_entries = 0;
@@ -130,7 +139,7 @@ class IntHashSet {
     }
 
     void enlarge() {
-        unsigned int num_buckets = buckets.size();
+        size_t num_buckets = buckets.size();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
         if (num_buckets > MAX_BUCKETS / 2) {
@@ -145,9 +154,9 @@ class IntHashSet {
         rehash(num_buckets * 2);
     }
 
-    int get_bucket(HashType hash) const {
+    size_t get_bucket(size_t hash) const {
         assert(!buckets.empty());
-        unsigned int num_buckets = buckets.size();
+        size_t num_buckets = buckets.size();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
         /* We want to return hash % num_buckets. The following line does this
@@ -159,7 +168,7 @@ class IntHashSet {
       Return distance from index1 to index2, only moving right and wrapping
       from the last to the first bucket.
     */
-    int get_distance(int index1, int index2) const {
+    size_t get_distance(size_t index1, size_t index2) const {
         assert(utils::in_bounds(index1, buckets));
         assert(utils::in_bounds(index2, buckets));
         if (index2 >= index1) {
@@ -169,7 +178,7 @@ class IntHashSet {
         }
     }
 
-    int find_next_free_bucket_index(int index) const {
+    size_t find_next_free_bucket_index(size_t index) const {
         assert(num_entries < capacity());
         assert(utils::in_bounds(index, buckets));
         while (buckets[index].full()) {
@@ -178,11 +187,11 @@ class IntHashSet {
         return index;
     }
 
-    KeyType find_equal_key(KeyType key, HashType hash) const {
+    Key find_equal_key(Key key, Hash hash) const {
         assert(hasher(key) == hash);
-        int ideal_index = get_bucket(hash);
+        size_t ideal_index = get_bucket(hash);
         for (int i = 0; i < MAX_DISTANCE; ++i) {
-            int index = get_bucket(ideal_index + i);
+            size_t index = get_bucket(ideal_index + i);
             const Bucket &bucket = buckets[index];
             if (bucket.full() && bucket.hash == hash && equal(bucket.key, key)) {
                 return bucket.key;
@@ -191,26 +200,70 @@ class IntHashSet {
         return Bucket::empty_bucket_key;
     }
 
+public:
+    IntHashSet(const Hasher &hasher, const Equal &equal)
+        : hasher(hasher),
+          equal(equal),
+          buckets(1),
+          num_entries(0),
+          num_resizes(0) {
+    }
+
+    size_t size() const {
+        return num_entries;
+    }
+
+    /*
+      Insert a key into the hash set.
+
+      Return a pair whose first item is the given key, or an equivalent key
+      already contained in the hash set. The second item in the pair is a bool
+      indicating whether a new key was inserted into the hash set.
+    */
+    std::pair<Key, bool> insert(Key key) {
+        assert(key >= 0);
+        return insert(key, hasher(key));
+    }
+
     /*
-      Private method that inserts a key and its corresponding hash into the
-      hash set.
+      Return a key contained in the hash set that is equal to the given key,
+      or -1 if there is none. The given key does not have to be a valid
+      entry of the hash set as long as the hasher and equality tester
+      support it. This can be used to look up data that has not been stored
+      under a key yet.
+    */
+    Key find(Key key) const {
+        assert(key >= 0);
+        return find_equal_key(key, hasher(key));
+    }
+
+    // Like find(key), but with a given hash value equal to hasher(key).
+    Key find(Key key, Hash hash) const {
+        assert(key >= 0);
+        return find_equal_key(key, hash);
+    }
+
+    /*
+      Insert a key with the given hash value, which must be equal to
+      hasher(key), into the hash set. This avoids computing the hash value
+      twice if the caller already knows it.
 
       The method ensures that each key is at most "max_distance" buckets away
       from its ideal bucket by moving the closest free bucket towards the ideal
       bucket. If this can't be achieved, we resize the vector, reinsert the old
       keys and try inserting the new key again.
 
-      For the return type, see the public insert() method.
+      For the return type, see insert(key).
 
-      Note that the private insert() may call enlarge() and therefore rehash(),
-      which itself calls the private insert() again.
+      Note that this method may call enlarge() and therefore rehash(),
+      which itself calls this method again.
     */
-    std::pair<KeyType, bool> insert(KeyType key, HashType hash) {
+    std::pair<Key, bool> insert(Key key, Hash hash) {
         assert(hasher(key) == hash);
 
         /* If the hash set already contains the key, return the key and a
            Boolean indicating that no new key has been inserted. */
-        KeyType equal_key = find_equal_key(key, hash);
+        Key equal_key = find_equal_key(key, hash);
         if (equal_key != Bucket::empty_bucket_key) {
             return std::make_pair(equal_key, false);
         }
@@ -222,10 +275,10 @@ class IntHashSet {
         assert(num_entries < capacity());
 
         // Compute ideal bucket.
-        int ideal_index = get_bucket(hash);
+        size_t ideal_index = get_bucket(hash);
 
         // Find first free bucket left of the ideal bucket.
-        int free_index = find_next_free_bucket_index(ideal_index);
+        size_t free_index = find_next_free_bucket_index(ideal_index);
 
         /*
           While the free bucket is too far from the ideal bucket, move the free
@@ -236,15 +289,14 @@ class IntHashSet {
         */
         while (get_distance(ideal_index, free_index) >= MAX_DISTANCE) {
             bool swapped = false;
-            int num_buckets = capacity();
-            int max_offset = std::min(MAX_DISTANCE, num_buckets) - 1;
+            size_t num_buckets = capacity();
+            int max_offset = std::min<size_t>(MAX_DISTANCE, num_buckets) - 1;
             for (int offset = max_offset; offset >= 1; --offset) {
-                assert(offset < num_buckets);
-                int candidate_index = free_index + num_buckets - offset;
-                assert(candidate_index >= 0);
+                assert(static_cast<size_t>(offset) < num_buckets);
+                size_t candidate_index = free_index + num_buckets - offset;
                 candidate_index = get_bucket(candidate_index);
-                HashType candidate_hash = buckets[candidate_index].hash;
-                int candidate_ideal_index = get_bucket(candidate_hash);
+                Hash candidate_hash = buckets[candidate_index].hash;
+                size_t candidate_ideal_index = get_bucket(candidate_hash);
                 if (get_distance(candidate_ideal_index, free_index) < MAX_DISTANCE) {
                     // Candidate can be swapped.
                     std::swap(buckets[candidate_index], buckets[free_index]);
@@ -267,35 +319,10 @@ class IntHashSet {
         return std::make_pair(key, true);
     }
 
-public:
-    IntHashSet(const Hasher &hasher, const Equal &equal)
-        : hasher(hasher),
-          equal(equal),
-          buckets(1),
-          num_entries(0),
-          num_resizes(0) {
-    }
-
-    int size() const {
-        return num_entries;
-    }
-
-    /*
-      Insert a key into the hash set.
-
-      Return a pair whose first item is the given key, or an equivalent key
-      already contained in the hash set. The second item in the pair is a bool
-      indicating whether a new key was inserted into the hash set.
-    */
-    std::pair<KeyType, bool> insert(KeyType key) {
-        assert(key >= 0);
-        return insert(key, hasher(key));
-    }
-
     void dump() const {
-        int num_buckets = capacity();
+        size_t num_buckets = capacity();
         utils::g_log << "[";
-        for (int i = 0; i < num_buckets; ++i) {
+        for (size_t i = 0; i < num_buckets; ++i) {
             const Bucket &bucket = buckets[i];
             if (bucket.full()) {
                 utils::g_log << bucket.key;
@@ -311,7 +338,7 @@ public:
 
     void print_statistics() const {
         assert(!buckets.empty());
-        int num_buckets = capacity();
+        size_t num_buckets = capacity();
         assert(num_buckets != 0);
         utils::g_log << "Int hash set load factor: " << num_entries << "/"
                      << num_buckets << " = "
@@ -321,11 +348,11 @@ public:
     }
 };
 
-template<typename Hasher, typename Equal>
-const int IntHashSet<Hasher, Equal>::MAX_DISTANCE;
+template<typename Hasher, typename Equal, typename Key, typename Hash>
+const int IntHashSet<Hasher, Equal, Key, Hash>::MAX_DISTANCE;
 
-template<typename Hasher, typename Equal>
-const unsigned int IntHashSet<Hasher, Equal>::MAX_BUCKETS;
+template<typename Hasher, typename Equal, typename Key, typename Hash>
+const size_t IntHashSet<Hasher, Equal, Key, Hash>::MAX_BUCKETS;
 }
 
 #endif
@@ -1,5 +1,7 @@
 #include "int_packer.h"
 
+#include "../abstract_task.h"
+
 #include <cassert>
 
 using namespace std;
@@ -60,7 +62,7 @@ public:
     void set(Bin *buffer, int value) const {
         assert(value >= 0 && value < range);
         Bin &bin = buffer[bin_index];
-        bin = (bin & clear_mask) | (value << shift);
+        bin = (bin & clear_mask) | (Bin(value) << shift);
     }
 };
 
@@ -81,6 +83,24 @@ void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
 
+void IntPacker::unpack_all(const Bin *buffer, int *values) const {
+    const UnpackEntry *entry = unpack_entries.data();
+    for (int bin_index = 0; bin_index < num_bins; ++bin_index) {
+        Bin bin = buffer[bin_index];
+        const UnpackEntry *bin_end = unpack_entries.data() + bin_begin[bin_index + 1];
+        for (; entry != bin_end; ++entry) {
+            values[entry->var] = (bin >> entry->shift) & entry->mask;
+        }
+    }
+}
+
+void IntPacker::apply_effects(
+    Bin *buffer, const FactPair *effects, int num_effects) const {
+    for (int i = 0; i < num_effects; ++i) {
+        var_infos[effects[i].var].set(buffer, effects[i].value);
+    }
+}
+
 void IntPacker::pack_bins(const vector<int> &ranges) {
     assert(var_infos.empty());
 
@@ -99,9 +119,13 @@ void IntPacker::pack_bins(const vector<int> &ranges) {
         bits_to_vars[bits].push_back(var);
     }
 
+    unpack_entries.reserve(num_vars);
+    bin_begin.push_back(0);
     int packed_vars = 0;
-    while (packed_vars != num_vars)
+    while (packed_vars != num_vars) {
         packed_vars += pack_one_bin(ranges, bits_to_vars);
+        bin_begin.push_back(unpack_entries.size());
+    }
 }
 
 int IntPacker::pack_one_bin(const vector<int> &ranges,
@@ -134,6 +158,9 @@ int IntPacker::pack_one_bin(const vector<int> &ranges,
         best_fit_vars.pop_back();
 
         var_infos[var] = VariableInfo(ranges[var], bin_index, used_bits);
+        // Values fit into an int (see constructor), so the mask does too.
+        unsigned int mask = (1U << bits) - 1;
+        unpack_entries.push_back({var, used_bits, mask});
         used_bits += bits;
         ++num_vars_in_bin;
     }
@@ -1,8 +1,11 @@
 #ifndef ALGORITHMS_INT_PACKER_H
 #define ALGORITHMS_INT_PACKER_H
 
+#include <cstdint>
 #include <vector>
 
+struct FactPair;
+
 /*
   Utility class to pack lots of unsigned integers (called "variables"
   in the code below) with a small domain {0, ..., range - 1}
@@ -12,6 +15,9 @@
   For example, if we have 40 binary variables and 20 variables with
   range 4, storing them would theoretically require at least 80 bits,
   and this class would pack them into 12 bytes (three 4-byte "bins").
+  If the build is configured with USE_64_BIT_STATE_BINS, bins have 8
+  bytes, which wastes fewer bits at bin boundaries; in the example,
+  this gives 16 bytes (two 8-byte bins).
 
   Uses a greedy bin-packing strategy to pack the variables, which
   should be close to optimal in most cases. (See code comments for
@@ -20,15 +26,31 @@
 namespace int_packer {
 class IntPacker {
     class VariableInfo;
+    struct UnpackEntry {
+        int var;
+        int shift;
+        unsigned int mask;
+    };
 
     std::vector<VariableInfo> var_infos;
     int num_bins;
+    /*
+      The variables of each bin, in the order in which they were packed:
+      the entries of bin i are unpack_entries[bin_begin[i]] up to
+      unpack_entries[bin_begin[i + 1] - 1]. Used by unpack_all().
+    */
+    std::vector<UnpackEntry> unpack_entries;
+    std::vector<int> bin_begin;
 
     int pack_one_bin(const std::vector<int> &ranges,
                      std::vector<std::vector<int>> &bits_to_vars);
     void pack_bins(const std::vector<int> &ranges);
 public:
+#ifdef USE_64_BIT_STATE_BINS
+    typedef std::uint64_t Bin;
+#else
     typedef unsigned int Bin;
+#endif
 
     /*
       The constructor takes the range for each variable. The domain of
@@ -42,6 +64,17 @@ public:
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    /*
+      Write the values of all variables to values, which must have room
+      for one entry per variable. Unlike calling get() for each
+      variable, this loads every bin only once and then extracts the
+      variables stored in it by shifting and masking.
+    */
+    void unpack_all(const Bin *buffer, int *values) const;
+
+    // Set the given facts in order, i.e., later facts overwrite earlier ones.
+    void apply_effects(Bin *buffer, const FactPair *effects, int num_effects) const;
+
     int get_num_bins() const {return num_bins;}
 };
 }
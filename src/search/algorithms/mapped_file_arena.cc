@@ -0,0 +1,133 @@
+#include "mapped_file_arena.h"
+
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace mapped_file_arena {
+static void exit_with_system_error(const string &msg) {
+    cerr << "Mapped file arena: " << msg << ": " << strerror(errno) << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+}
+
+static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+MappedFileArena::MappedFileArena(const string &directory)
+    : directory(directory),
+      file_descriptor(-1),
+      file_size(0),
+      chunk_pos(nullptr),
+      chunk_end(nullptr),
+      num_allocated_bytes(0) {
+    string path_template = directory + "/downward-spill-XXXXXX";
+    vector<char> path(path_template.begin(), path_template.end());
+    path.push_back('\0');
+    file_descriptor = mkstemp(path.data());
+    if (file_descriptor == -1) {
+        cerr << "Mapped file arena: could not create a file in "
+             << directory << ": " << strerror(errno) << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    // Nobody else needs the file, so we can remove its name right away.
+    unlink(path.data());
+}
+
+MappedFileArena::~MappedFileArena() {
+    for (const pair<char *, size_t> &mapping : mappings) {
+        munmap(mapping.first, mapping.second);
+    }
+    close(file_descriptor);
+}
+
+char *MappedFileArena::map_chunk(size_t num_bytes) {
+    off_t offset = file_size;
+#if OPERATING_SYSTEM == LINUX
+    /*
+      Reserve the disk space now, so that we can report a full disk here
+      instead of getting a SIGBUS when the kernel writes the pages back.
+    */
+    int error = posix_fallocate(file_descriptor, offset, num_bytes);
+    if (error) {
+        errno = error;
+        exit_with_system_error("could not extend the spill file");
+    }
+#else
+    if (ftruncate(file_descriptor, offset + num_bytes) == -1) {
+        exit_with_system_error("could not extend the spill file");
+    }
+#endif
+    void *chunk = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, file_descriptor, offset);
+    if (chunk == MAP_FAILED) {
+        exit_with_system_error("could not map the spill file");
+    }
+    file_size += num_bytes;
+    mappings.emplace_back(static_cast<char *>(chunk), num_bytes);
+    return static_cast<char *>(chunk);
+}
+#else
+MappedFileArena::MappedFileArena(const string &directory)
+    : directory(directory),
+      file_descriptor(-1),
+      file_size(0),
+      chunk_pos(nullptr),
+      chunk_end(nullptr),
+      num_allocated_bytes(0) {
+    cerr << "Mapped file arenas are not supported on this operating system."
+         << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+}
+
+MappedFileArena::~MappedFileArena() {
+}
+
+char *MappedFileArena::map_chunk(size_t) {
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+}
+#endif
+
+void *MappedFileArena::allocate(size_t num_bytes, size_t alignment) {
+    lock_guard<mutex> lock(allocation_mutex);
+    num_allocated_bytes += num_bytes;
+    if (num_bytes > CHUNK_BYTES / 2) {
+        // Give large requests their own chunk to avoid wasting space.
+        return map_chunk(round_up(num_bytes, CHUNK_BYTES));
+    }
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(chunk_pos) %
+                      alignment) % alignment;
+    if (!chunk_pos ||
+        static_cast<size_t>(chunk_end - chunk_pos) < padding + num_bytes) {
+        chunk_pos = map_chunk(CHUNK_BYTES);
+        chunk_end = chunk_pos + CHUNK_BYTES;
+        padding = 0;
+    }
+    char *result = chunk_pos + padding;
+    chunk_pos = result + num_bytes;
+    return result;
+}
+
+void MappedFileArena::deallocate(void *, size_t) {
+    // Memory is only released when the arena is destroyed.
+}
+
+void MappedFileArena::print_statistics() const {
+    utils::g_log << "Spill file size in " << directory << ": "
+                 << file_size / 1024 << " KB ("
+                 << num_allocated_bytes / 1024 << " KB allocated)" << endl;
+}
+}
@@ -0,0 +1,114 @@
+#ifndef ALGORITHMS_MAPPED_FILE_ARENA_H
+#define ALGORITHMS_MAPPED_FILE_ARENA_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+  MappedFileArena hands out memory from a temporary file that is mapped
+  into the address space of the process. The file lives in a given
+  directory (ideally on a fast local disk) and is deleted from the file
+  system as soon as it has been created, so it disappears with the
+  process.
+
+  Since the pages of a shared file mapping are backed by the file
+  instead of swap space, the kernel can write cold pages to disk and
+  drop them from physical memory when the process runs short of it.
+  Containers whose memory comes from the arena therefore slow down
+  instead of failing when a search slightly exceeds the available
+  physical memory (e.g., a cgroup limit). This does not help against
+  limits on the address space (e.g., ulimit -v), since the mapped file
+  counts towards the address space.
+
+  The arena only supports allocating memory. Deallocated memory is not
+  reused and is only freed when the arena is destroyed. This fits the
+  use in SegmentedVector and SegmentedArrayVector, which only free their
+  segments on destruction.
+
+  ArenaAllocator allocates from a MappedFileArena if it is given one and
+  from the heap otherwise. This allows choosing the memory source of
+  each container at runtime.
+*/
+
+namespace mapped_file_arena {
+class MappedFileArena {
+    /*
+      Every chunk costs one posix_fallocate and one mmap call and a
+      separate mapping, of which Linux allows about 65000 per process by
+      default (vm.max_map_count). With 64 MB chunks, these limits admit
+      spill files of several TB, while at most one chunk of disk space is
+      reserved but unused. The value is a multiple of the page size and of
+      the 2 MB huge page size, so all chunks start at offsets that mmap
+      accepts and that file systems allocate in whole extents.
+    */
+    static const size_t CHUNK_BYTES = 64 * 1024 * 1024;
+
+    const std::string directory;
+    int file_descriptor;
+    size_t file_size;
+    std::vector<std::pair<char *, size_t>> mappings;
+    char *chunk_pos;
+    char *chunk_end;
+    size_t num_allocated_bytes;
+    std::mutex allocation_mutex;
+
+    char *map_chunk(size_t num_bytes);
+public:
+    explicit MappedFileArena(const std::string &directory);
+    ~MappedFileArena();
+
+    MappedFileArena(const MappedFileArena &) = delete;
+    MappedFileArena &operator=(const MappedFileArena &) = delete;
+
+    // Allocate num_bytes bytes aligned to alignment (a power of 2).
+    void *allocate(size_t num_bytes, size_t alignment);
+    void deallocate(void *ptr, size_t num_bytes);
+
+    void print_statistics() const;
+};
+
+
+template<class T>
+class ArenaAllocator : public std::allocator<T> {
+    template<class U>
+    friend class ArenaAllocator;
+
+    std::shared_ptr<MappedFileArena> arena;
+public:
+    template<class U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    ArenaAllocator() = default;
+
+    explicit ArenaAllocator(const std::shared_ptr<MappedFileArena> &arena)
+        : arena(arena) {
+    }
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U> &other)
+        : arena(other.arena) {
+    }
+
+    T *allocate(size_t n) {
+        if (arena) {
+            return static_cast<T *>(
+                arena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return std::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T *ptr, size_t n) {
+        if (arena) {
+            arena->deallocate(ptr, n * sizeof(T));
+        } else {
+            std::allocator<T>::deallocate(ptr, n);
+        }
+    }
+};
+}
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef ALGORITHMS_MULTI_QUEUE_H
+#define ALGORITHMS_MULTI_QUEUE_H
+
+#include "../utils/logging.h"
+
+#include <optional.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+/*
+  MultiQueue (Rihani, Sanders and Dementiev, 2015) is a relaxed priority
+  queue that several threads can push to and pop from at the same time.
+  It consists of a number of sequential binary heaps with a lock each.
+  push() adds the element to a random heap. pop() looks at the minimal
+  keys of two random heaps and removes the minimum of the better one.
+  If a lock is taken, the operation tries other random heaps instead of
+  waiting. With c * p heaps for p threads, contention is low, and the
+  removed elements are close to the global minimum in expectation.
+
+  Since the order is relaxed, pop() may return an element whose key is
+  larger than the global minimum. As a cheap measure of this, we count
+  the heaps whose minimal key is smaller than that of the removed element
+  (the rank error of the heaps). Each of them contains at least one
+  element with a smaller key, so this is a lower bound for the rank error
+  of the removed element among all elements.
+
+  Keys must be smaller than std::numeric_limits<int>::max(). Elements
+  with equal keys are removed in no particular order.
+*/
+namespace multi_queue {
+template<typename Value>
+class MultiQueue {
+public:
+    typedef std::pair<int, Value> Entry;
+
+private:
+    static const int EMPTY_KEY = std::numeric_limits<int>::max();
+    // Number of random heaps we try before we fall back to a full scan.
+    static const int MAX_RANDOM_ATTEMPTS = 16;
+
+    struct compare_func {
+        bool operator()(const Entry &lhs, const Entry &rhs) const {
+            return lhs.first > rhs.first;
+        }
+    };
+
+    struct Heap {
+        std::mutex heap_mutex;
+        std::vector<Entry> entries;
+        /*
+          Minimal key of the entries or EMPTY_KEY. It is only written while
+          holding heap_mutex, but read without it to select heaps.
+        */
+        std::atomic<int> min_key;
+        // Avoid false sharing between the locks of neighboring heaps.
+        char padding[64];
+
+        Heap()
+            : min_key(EMPTY_KEY) {
+        }
+
+        void update_min_key() {
+            min_key.store(entries.empty() ? EMPTY_KEY : entries.front().first,
+                          std::memory_order_release);
+        }
+    };
+
+    std::vector<Heap> heaps;
+    std::atomic<long long> size;
+
+    std::atomic<long long> num_pops;
+    std::atomic<long long> num_inexact_pops;
+    std::atomic<long long> sum_rank_errors;
+    std::atomic<int> max_rank_error;
+    std::atomic<long long> num_lock_conflicts;
+
+    int get_random_heap() const {
+        /*
+          Each thread uses its own random number generator. The seeds only
+          depend on the order in which threads first use a MultiQueue, so
+          single-threaded runs are reproducible.
+        */
+        static std::atomic<unsigned int> num_generators(0);
+        static thread_local std::minstd_rand rng(
+            1 + num_generators.fetch_add(1, std::memory_order_relaxed));
+        return std::uniform_int_distribution<int>(0, heaps.size() - 1)(rng);
+    }
+
+    // Return the index of a heap with minimal min_key.
+    int find_best_heap() const {
+        int best = 0;
+        for (size_t i = 1; i < heaps.size(); ++i) {
+            if (heaps[i].min_key.load(std::memory_order_acquire) <
+                heaps[best].min_key.load(std::memory_order_acquire))
+                best = i;
+        }
+        return best;
+    }
+
+    int compute_rank_error(int key) const {
+        int rank_error = 0;
+        for (const Heap &heap : heaps) {
+            if (heap.min_key.load(std::memory_order_relaxed) < key)
+                ++rank_error;
+        }
+        return rank_error;
+    }
+
+    void update_statistics(int key) {
+        int rank_error = compute_rank_error(key);
+        num_pops.fetch_add(1, std::memory_order_relaxed);
+        if (rank_error > 0) {
+            num_inexact_pops.fetch_add(1, std::memory_order_relaxed);
+            sum_rank_errors.fetch_add(rank_error, std::memory_order_relaxed);
+            int old_max = max_rank_error.load(std::memory_order_relaxed);
+            while (rank_error > old_max &&
+                   !max_rank_error.compare_exchange_weak(
+                       old_max, rank_error, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+public:
+    explicit MultiQueue(int num_heaps)
+        : heaps(num_heaps),
+          size(0),
+          num_pops(0),
+          num_inexact_pops(0),
+          sum_rank_errors(0),
+          max_rank_error(0),
+          num_lock_conflicts(0) {
+        assert(num_heaps >= 1);
+    }
+
+    MultiQueue(const MultiQueue &) = delete;
+    MultiQueue &operator=(const MultiQueue &) = delete;
+
+    void push(int key, const Value &value) {
+        assert(key != EMPTY_KEY);
+        while (true) {
+            Heap &heap = heaps[get_random_heap()];
+            std::unique_lock<std::mutex> lock(heap.heap_mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                num_lock_conflicts.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            heap.entries.push_back(std::make_pair(key, value));
+            std::push_heap(heap.entries.begin(), heap.entries.end(), compare_func());
+            heap.update_min_key();
+            break;
+        }
+        size.fetch_add(1, std::memory_order_release);
+    }
+
+    /*
+      Remove and return an entry with a small key, or nullopt if the queue
+      is empty. While other threads push entries, the result may be
+      nullopt although the queue is not empty afterwards.
+    */
+    tl::optional<Entry> try_pop() {
+        int attempt = 0;
+        while (size.load(std::memory_order_acquire) > 0) {
+            int index;
+            if (attempt < MAX_RANDOM_ATTEMPTS) {
+                int first = get_random_heap();
+                int second = get_random_heap();
+                index = heaps[second].min_key.load(std::memory_order_acquire) <
+                    heaps[first].min_key.load(std::memory_order_acquire) ?
+                    second : first;
+            } else {
+                index = find_best_heap();
+            }
+            ++attempt;
+            Heap &heap = heaps[index];
+            if (heap.min_key.load(std::memory_order_acquire) == EMPTY_KEY)
+                continue;
+            std::unique_lock<std::mutex> lock(heap.heap_mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                num_lock_conflicts.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (heap.entries.empty())
+                continue;
+            std::pop_heap(heap.entries.begin(), heap.entries.end(), compare_func());
+            Entry result = heap.entries.back();
+            heap.entries.pop_back();
+            heap.update_min_key();
+            lock.unlock();
+            size.fetch_sub(1, std::memory_order_release);
+            update_statistics(result.first);
+            return result;
+        }
+        return tl::nullopt;
+    }
+
+    bool empty() const {
+        return size.load(std::memory_order_acquire) == 0;
+    }
+
+    // Not thread-safe.
+    void clear() {
+        for (Heap &heap : heaps) {
+            heap.entries.clear();
+            heap.update_min_key();
+        }
+        size.store(0);
+    }
+
+    int get_num_heaps() const {
+        return heaps.size();
+    }
+
+    void print_statistics() const {
+        long long pops = num_pops.load();
+        utils::g_log << "MultiQueue heaps: " << heaps.size() << std::endl;
+        utils::g_log << "MultiQueue pops: " << pops << std::endl;
+        utils::g_log << "MultiQueue pops with rank error: "
+                     << num_inexact_pops.load() << std::endl;
+        utils::g_log << "MultiQueue average rank error: "
+                     << (pops ? static_cast<double>(sum_rank_errors.load()) / pops : 0)
+                     << std::endl;
+        utils::g_log << "MultiQueue maximal rank error: "
+                     << max_rank_error.load() << std::endl;
+        utils::g_log << "MultiQueue lock conflicts: "
+                     << num_lock_conflicts.load() << std::endl;
+    }
+};
+}
+
+#endif
@@ -72,6 +72,19 @@ public:
         return items;
     }
 
+    /*
+      Like pop_as_vector(), but continue with the given empty vector as
+      storage for the items, so that callers can recycle its capacity.
+    */
+    std::vector<T> pop_as_vector(std::vector<T> &&storage) {
+        assert(storage.empty());
+        std::vector<T> items = std::move(ordered_items);
+        ordered_items = std::move(storage);
+        unordered_items.clear();
+        assert(empty());
+        return items;
+    }
+
     typename std::vector<T>::const_iterator begin() const {
         return ordered_items.begin();
     }
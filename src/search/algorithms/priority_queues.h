@@ -4,6 +4,7 @@
 #include "../utils/collections.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -12,14 +13,20 @@
 #include <vector>
 
 /*
-  We define three priority queue classes here: HeapQueue (heap-based),
-  BucketQueue (bucket-based), and AdaptiveQueue (starts out bucket-based,
-  transforms into heap-based if that seems to make sense).
+  We define four priority queue classes here: HeapQueue (heap-based),
+  RadixHeapQueue (radix heap, only for monotone use), BucketQueue
+  (bucket-based), and AdaptiveQueue (starts out bucket-based,
+  transforms into one of the others if that seems to make sense).
 
   More precisely, an AdaptiveQueue is converted from a BucketQueue to
-  a HeapQueue when the number of required buckets exceeds both
+  another queue when the number of required buckets exceeds both
   BucketQueue::MIN_BUCKETS_BEFORE_SWITCH and the total number of
   pushes to the queue since it was last clear()ed or constructed.
+  If no key pushed so far was smaller than the last popped key, which
+  holds for Dijkstra-style uses with non-negative costs, the new queue
+  is a RadixHeapQueue, and otherwise a HeapQueue. A RadixHeapQueue is
+  converted to a HeapQueue as soon as a key smaller than the last
+  popped key is pushed.
 
   Note: AdaptiveQueue does not derive from AbstractQueue since this is
   currently not necessary, and by not deriving we can save virtual
@@ -127,6 +134,174 @@ public:
         return result;
     }
 
+    static HeapQueue<Value> *create_from_entries_destructively(
+        std::vector<Entry> &entries) {
+        // Create a new heap from the entries in any order.
+        // The passed-in vector is cleared as a side effect.
+        HeapQueue<Value> *result = new HeapQueue<Value>;
+        result->heap.c.swap(entries);
+        std::make_heap(result->heap.c.begin(), result->heap.c.end(),
+                       compare_func());
+        return result;
+    }
+
+    virtual void add_virtual_pushes(int /*num_extra_pushes*/) {
+    }
+};
+
+
+/*
+  Radix heap (Ahuja, Mehlhorn, Orlin and Tarjan, 1990) for monotone use,
+  i.e., no pushed key may be smaller than the last popped key. An entry
+  with key k is stored in bucket 0 if k equals the last popped key and
+  otherwise in the bucket given by the position of the highest bit in
+  which k and the last popped key differ. When bucket 0 is empty, pop()
+  moves the entries of the first non-empty bucket to lower buckets
+  relative to their minimal key. Each entry moves at most once per bit,
+  so push and pop take amortized O(log C) time for a maximal key C, and
+  the buckets are plain vectors that are read sequentially.
+*/
+template<typename Value>
+class RadixHeapQueue : public AbstractQueue<Value> {
+    static const int NUM_BUCKETS = std::numeric_limits<unsigned int>::digits + 1;
+    static const bool DEBUG = false;
+
+    typedef typename AbstractQueue<Value>::Entry Entry;
+    typedef std::vector<Entry> Bucket;
+
+    std::vector<Bucket> buckets;
+    Bucket redistributed_entries;
+    int last_popped_key;
+    int num_entries;
+
+    bool is_valid_key(int key) const {
+        int infinity = std::numeric_limits<int>::max();
+        return key >= last_popped_key && key != infinity;
+    }
+
+    static int get_highest_bit_position(unsigned int value) {
+        assert(value != 0);
+#ifdef __GNUC__
+        return std::numeric_limits<unsigned int>::digits - __builtin_clz(value);
+#else
+        int position = 0;
+        while (value) {
+            value >>= 1;
+            ++position;
+        }
+        return position;
+#endif
+    }
+
+    int get_bucket_no(int key) const {
+        if (key == last_popped_key)
+            return 0;
+        return get_highest_bit_position(
+            static_cast<unsigned int>(key) ^
+            static_cast<unsigned int>(last_popped_key));
+    }
+
+    void redistribute() {
+        // Move the entries of the first non-empty bucket to lower buckets.
+        assert(buckets[0].empty());
+        int bucket_no = 1;
+        while (buckets[bucket_no].empty())
+            ++bucket_no;
+        redistributed_entries.swap(buckets[bucket_no]);
+        int min_key = std::numeric_limits<int>::max();
+        for (const Entry &entry : redistributed_entries)
+            min_key = std::min(min_key, entry.first);
+        last_popped_key = min_key;
+        for (const Entry &entry : redistributed_entries)
+            buckets[get_bucket_no(entry.first)].push_back(entry);
+        redistributed_entries.clear();
+    }
+
+    void extract_entries(std::vector<Entry> &result) {
+        // Move all entries to result, clearing this queue as a side effect.
+        assert(result.empty());
+        result.reserve(num_entries);
+        for (Bucket &bucket : buckets) {
+            result.insert(result.end(), bucket.begin(), bucket.end());
+            Bucket empty_bucket;
+            bucket.swap(empty_bucket);
+        }
+        num_entries = 0;
+    }
+
+public:
+    explicit RadixHeapQueue(int last_popped_key = 0)
+        : buckets(NUM_BUCKETS),
+          last_popped_key(last_popped_key),
+          num_entries(0) {
+        assert(last_popped_key >= 0);
+    }
+
+    virtual ~RadixHeapQueue() {
+    }
+
+    virtual void push(int key, const Value &value) {
+        assert(is_valid_key(key));
+        ++num_entries;
+        buckets[get_bucket_no(key)].push_back(std::make_pair(key, value));
+    }
+
+    virtual Entry pop() {
+        assert(num_entries > 0);
+        --num_entries;
+        if (buckets[0].empty())
+            redistribute();
+        Entry result = buckets[0].back();
+        buckets[0].pop_back();
+        return result;
+    }
+
+    int get_min_key() {
+        // Return the smallest key without removing its entry.
+        assert(num_entries > 0);
+        if (buckets[0].empty())
+            redistribute();
+        return last_popped_key;
+    }
+
+    virtual bool empty() const {
+        return num_entries == 0;
+    }
+
+    virtual void clear() {
+        for (Bucket &bucket : buckets)
+            bucket.clear();
+        last_popped_key = 0;
+        num_entries = 0;
+    }
+
+    virtual AbstractQueue<Value> *convert_if_necessary(int key) {
+        if (key < last_popped_key) {
+            if (DEBUG) {
+                utils::g_log << "Switch from radix heap to heap-based queue "
+                             << "at key = " << key
+                             << ", last popped key = " << last_popped_key
+                             << std::endl;
+            }
+            std::vector<Entry> entries;
+            extract_entries(entries);
+            return HeapQueue<Value>::create_from_entries_destructively(entries);
+        }
+        return this;
+    }
+
+    static RadixHeapQueue<Value> *create_from_sorted_entries_destructively(
+        std::vector<Entry> &entries, int last_popped_key) {
+        // Create a new radix heap from the entries, which must be sorted
+        // and must not have keys smaller than last_popped_key.
+        // The passed-in vector is cleared as a side effect.
+        RadixHeapQueue<Value> *result = new RadixHeapQueue<Value>(last_popped_key);
+        for (const Entry &entry : entries)
+            result->push(entry.first, entry.second);
+        entries.clear();
+        return result;
+    }
+
     virtual void add_virtual_pushes(int /*num_extra_pushes*/) {
     }
 };
@@ -144,6 +319,9 @@ class BucketQueue : public AbstractQueue<Value> {
     mutable int current_bucket_no;
     int num_entries;
     int num_pushes;
+    int last_popped_key;
+    // True if no pushed key was smaller than the last popped key.
+    bool is_monotone;
 
     bool is_valid_key(int key) const {
         int infinity = std::numeric_limits<int>::max();
@@ -173,7 +351,9 @@ class BucketQueue : public AbstractQueue<Value> {
         current_bucket_no = 0;
     }
 public:
-    BucketQueue() : current_bucket_no(0), num_entries(0), num_pushes(0) {
+    BucketQueue()
+        : current_bucket_no(0), num_entries(0), num_pushes(0),
+          last_popped_key(0), is_monotone(true) {
     }
 
     virtual ~BucketQueue() {
@@ -184,6 +364,8 @@ public:
         ++num_entries;
         ++num_pushes;
         assert(num_pushes > 0); // Check against overflow.
+        if (key < last_popped_key)
+            is_monotone = false;
         int num_buckets = buckets.size();
         if (key >= num_buckets)
             buckets.resize(key + 1);
@@ -199,6 +381,7 @@ public:
         Bucket &current_bucket = buckets[current_bucket_no];
         Value top_element = current_bucket.back();
         current_bucket.pop_back();
+        last_popped_key = current_bucket_no;
         return std::make_pair(current_bucket_no, top_element);
     }
 
@@ -217,18 +400,26 @@ public:
         current_bucket_no = 0;
         assert(num_entries == 0);
         num_pushes = 0;
+        last_popped_key = 0;
+        is_monotone = true;
     }
 
     virtual AbstractQueue<Value> *convert_if_necessary(int key) {
         assert(is_valid_key(key));
         if (key >= MIN_BUCKETS_BEFORE_SWITCH && key > num_pushes) {
+            bool use_radix_heap = is_monotone && key >= last_popped_key;
             if (DEBUG) {
-                utils::g_log << "Switch from bucket-based to heap-based queue "
-                             << "at key = " << key
+                utils::g_log << "Switch from bucket-based to "
+                             << (use_radix_heap ? "radix" : "heap-based")
+                             << " queue at key = " << key
                              << ", num_pushes = " << num_pushes << std::endl;
             }
             std::vector<Entry> entries;
             extract_sorted_entries(entries);
+            if (use_radix_heap) {
+                return RadixHeapQueue<Value>::create_from_sorted_entries_destructively(
+                    entries, last_popped_key);
+            }
             return HeapQueue<Value>::create_from_sorted_entries_destructively(
                 entries);
         }
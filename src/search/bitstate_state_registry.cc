@@ -0,0 +1,230 @@
+#include "bitstate_state_registry.h"
+
+#include "compressed_state_registry.h"
+#include "option_parser.h"
+#include "task_proxy.h"
+
+#include "utils/hash.h"
+#include "utils/logging.h"
+#include "utils/memory.h"
+#include "utils/system.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+static const size_t BITS_PER_WORD = 64;
+
+// Finalizer of SplitMix64, used to derive the second hash value.
+static uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+const BitstateStateRegistry::Slot BitstateStateRegistry::RELEASED;
+
+BitstateStateRegistry::BitstateStateRegistry(
+    const TaskProxy &task_proxy, size_t num_bytes, int num_hash_functions,
+    const shared_ptr<mapped_file_arena::MappedFileArena> &arena)
+    : StateRegistry(task_proxy, false, false),
+      num_bins(get_bins_per_state()),
+      num_hash_functions(num_hash_functions),
+      num_bits(((num_bytes * 8 + BITS_PER_WORD - 1) / BITS_PER_WORD) * BITS_PER_WORD),
+      bits(num_bits / BITS_PER_WORD, 0),
+      buffer(num_bins),
+      state_data(num_bins, mapped_file_arena::ArenaAllocator<PackedStateBin>(arena)) {
+    assert(num_bits > 0);
+    utils::g_log << "Bitstate hashing with " << num_hash_functions
+                 << " hash function(s) and " << num_bits << " bits" << endl;
+}
+
+BitstateStateRegistry::~BitstateStateRegistry() {
+}
+
+bool BitstateStateRegistry::insert_buffer() {
+    utils::HashState hash_state;
+    for (PackedStateBin bin : buffer) {
+        utils::feed(hash_state, bin);
+    }
+    /*
+      We derive the k bit positions from two hash values h1 and h2 as
+      h1 + i * h2 (Kirsch and Mitzenmacher, 2006).
+    */
+    uint64_t hash = hash_state.get_hash64();
+    uint64_t step = mix(hash) | 1;
+    bool is_new = false;
+    for (int i = 0; i < num_hash_functions; ++i) {
+        uint64_t pos = hash % num_bits;
+        uint64_t mask = uint64_t(1) << (pos % BITS_PER_WORD);
+        uint64_t &word = bits[pos / BITS_PER_WORD];
+        if (!(word & mask)) {
+            word |= mask;
+            is_new = true;
+        }
+        hash += step;
+    }
+    return is_new;
+}
+
+StateID BitstateStateRegistry::register_buffer() {
+    StateID::value_type id = state_slots.size();
+    if (id == numeric_limits<StateID::value_type>::max()) {
+        cerr << "State registry exceeded the maximum number of state IDs. "
+             << "Rebuild with USE_64_BIT_STATE_IDS to support more states."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    Slot slot;
+    if (free_slots.empty()) {
+        slot = state_data.size();
+        state_data.push_back(buffer.data());
+        slot_references.push_back(1);
+    } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        copy(buffer.begin(), buffer.end(), state_data[slot]);
+        slot_references[slot] = 1;
+    }
+    state_slots.push_back(slot);
+    num_states.store(id + 1, memory_order_relaxed);
+    return StateID(id);
+}
+
+BitstateStateRegistry::Slot BitstateStateRegistry::get_slot(StateID id) const {
+    Slot slot = state_slots[id.value];
+    assert(slot != RELEASED);
+    return slot;
+}
+
+tl::optional<GlobalState> BitstateStateRegistry::try_get_successor_state(
+    const GlobalState &predecessor, const OperatorProxy &op) {
+    compute_successor_data(predecessor, op, buffer.data());
+    if (!insert_buffer()) {
+        count_successor(true);
+        return tl::nullopt;
+    }
+    count_successor(false);
+    return lookup_stored_state(register_buffer());
+}
+
+void BitstateStateRegistry::retain_state(StateID id) {
+    ++slot_references[get_slot(id)];
+}
+
+void BitstateStateRegistry::release_state(StateID id) {
+    Slot slot = get_slot(id);
+    assert(slot_references[slot] > 0);
+    if (--slot_references[slot] == 0) {
+        free_slots.push_back(slot);
+        state_slots[id.value] = RELEASED;
+    }
+}
+
+GlobalState BitstateStateRegistry::lookup_stored_state(StateID id) const {
+    return GlobalState(state_data[get_slot(id)], *this, id);
+}
+
+GlobalState BitstateStateRegistry::register_initial_state() {
+    pack_initial_state(buffer.data());
+    insert_buffer();
+    initial_state_data = buffer;
+    return GlobalState(initial_state_data.data(), *this, register_buffer());
+}
+
+/*
+  verify_bitstate_options() rejects all configurations that would call the
+  following methods.
+*/
+GlobalState BitstateStateRegistry::get_successor_state(
+    const GlobalState &, const OperatorProxy &) {
+    ABORT("BitstateStateRegistry only supports try_get_successor_state()");
+}
+
+GlobalState BitstateStateRegistry::insert_state(const PackedStateBin *) {
+    ABORT("BitstateStateRegistry does not support inserting given states");
+}
+
+StateID BitstateStateRegistry::find_state(const PackedStateBin *) {
+    ABORT("BitstateStateRegistry does not support finding states");
+}
+
+void BitstateStateRegistry::print_statistics() const {
+    utils::g_log << "Number of registered states: " << size() << endl;
+    print_successor_statistics();
+    utils::g_log << "Bitstate stored states: "
+                 << state_data.size() - free_slots.size()
+                 << " (peak: " << state_data.size() << ")" << endl;
+    uint64_t num_set_bits = 0;
+    for (uint64_t word : bits) {
+        num_set_bits += bitset<BITS_PER_WORD>(word).count();
+    }
+    double fill_ratio = static_cast<double>(num_set_bits) / num_bits;
+    utils::g_log << "Bitstate fill ratio: " << fill_ratio << endl;
+    /*
+      A new state is pruned if all of its bits are set, so with the final
+      fill ratio, this is an upper bound for the probability of pruning
+      a new state.
+    */
+    utils::g_log << "Bitstate omission probability: "
+                 << pow(fill_ratio, num_hash_functions) << endl;
+}
+
+void add_bitstate_options_to_parser(OptionParser &parser) {
+    parser.add_option<int>(
+        "bitstate_mb",
+        "If positive, detect duplicates approximately with a bitstate table "
+        "(Bloom filter) of this many MiB instead of the hash set of the state "
+        "registry, and only keep the packed data of the states that the "
+        "search still needs (open states and, for lazy search, expanded states "
+        "with successors). Closed states then only need their search node info "
+        "and evaluator caches. New states whose bits are all set already are "
+        "pruned, so the search becomes incomplete and never reopens nodes. "
+        "Requires store_parents=true, state_hashing=packed_data and "
+        "state_compression=none.",
+        "0",
+        Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "bitstate_hash_functions",
+        "number of bits that the bitstate table sets for each state",
+        "3",
+        Bounds("1", "10"));
+}
+
+void verify_bitstate_options(OptionParser &parser, const Options &opts) {
+    if (parser.help_mode() || opts.get<int>("bitstate_mb") == 0) {
+        return;
+    }
+    /*
+      Without parent pointers, plans are reconstructed by looking up
+      predecessors with find_state().
+    */
+    if (!opts.get<bool>("store_parents")) {
+        parser.error("bitstate hashing requires store_parents=true");
+    }
+    if (opts.get<StateHashing>("state_hashing") != StateHashing::PACKED_DATA ||
+        opts.get<StateCompression>("state_compression") != StateCompression::NONE) {
+        parser.error("bitstate hashing requires state_hashing=packed_data "
+                     "and state_compression=none");
+    }
+}
+
+unique_ptr<StateRegistry> create_bitstate_state_registry(
+    const TaskProxy &task_proxy, const Options &opts,
+    const shared_ptr<mapped_file_arena::MappedFileArena> &arena) {
+    int num_mb = opts.get<int>("bitstate_mb", 0);
+    if (num_mb == 0) {
+        return nullptr;
+    }
+    return utils::make_unique_ptr<BitstateStateRegistry>(
+        task_proxy, static_cast<size_t>(num_mb) << 20,
+        opts.get<int>("bitstate_hash_functions"), arena);
+}
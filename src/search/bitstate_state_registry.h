@@ -0,0 +1,133 @@
+#ifndef BITSTATE_STATE_REGISTRY_H
+#define BITSTATE_STATE_REGISTRY_H
+
+#include "state_registry.h"
+
+#include "algorithms/segmented_vector.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional.hh>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+/*
+  A state registry with approximate duplicate detection by bitstate
+  hashing (as in the SPIN model checker): a Bloom filter with k hash
+  functions records all states that were registered so far. A generated
+  state is registered only if at least one of its k bits is unset (see
+  try_get_successor_state). All other states are treated as duplicates and
+  dropped.
+
+  Since the filter decides which states are new, the registry needs no
+  hash set and only keeps the packed data of the states that the search
+  still needs, in a pool of slots that are recycled. Every state starts
+  with one reference, the search adds references with retain_state() and
+  removes them with release_state(), and the slot of a state is recycled
+  once it has no references left. Eager search releases a state when it
+  expands it, so only the data of open states is kept. Lazy search cannot
+  tell when the last edge from a state leaves the open list, so it keeps
+  the data of expanded states with successors and only releases dead ends
+  and states without successors. Looking up a released state is not
+  allowed, and GlobalStates point into the slots, so they must not be used
+  after their state is released. State IDs stay valid, so search node
+  infos and plans (which are traced via parent IDs) are not affected.
+
+  Per released state, the search therefore only stores its search node info
+  and evaluator caches (e.g., cached heuristic values), and one state ID for
+  mapping the state ID to its slot. The price is completeness: with
+  probability roughly (1 - e^(-kn/m))^k for n states and m bits, a new
+  state collides with earlier states and is pruned. Also, duplicates never
+  reach the search, so cheaper paths to registered states are never found
+  and closed nodes are never reopened.
+
+  The registry cannot look up or register given states, so it does not
+  support get_successor_state(), insert_state() and find_state().
+  verify_bitstate_options() rejects the options that would need them.
+*/
+class BitstateStateRegistry : public StateRegistry {
+    using Slot = StateID::value_type;
+    static const Slot RELEASED = std::numeric_limits<Slot>::max();
+
+    const int num_bins;
+    const int num_hash_functions;
+    const std::uint64_t num_bits;
+    std::vector<std::uint64_t> bits;
+    std::vector<PackedStateBin> buffer;
+
+    // Slot of the data of each state in state_data, or RELEASED.
+    segmented_vector::SegmentedVector<Slot> state_slots;
+    StateDataPool state_data;
+    segmented_vector::SegmentedVector<int> slot_references;
+    std::vector<Slot> free_slots;
+
+    /*
+      The initial state is cached by get_initial_state(), so we keep a copy
+      of its data that stays valid when its slot is recycled.
+    */
+    std::vector<PackedStateBin> initial_state_data;
+
+    // Set the bits of the state in buffer. Return true if one was unset.
+    bool insert_buffer();
+    // Register the state in buffer with one reference.
+    StateID register_buffer();
+    Slot get_slot(StateID id) const;
+protected:
+    virtual GlobalState lookup_stored_state(StateID id) const override;
+    virtual GlobalState register_initial_state() override;
+public:
+    /*
+      The filter has num_bytes bytes. If arena is given, the data of the
+      states is stored in its memory-mapped file.
+    */
+    BitstateStateRegistry(
+        const TaskProxy &task_proxy, std::size_t num_bytes,
+        int num_hash_functions,
+        const std::shared_ptr<mapped_file_arena::MappedFileArena> &arena = nullptr);
+    virtual ~BitstateStateRegistry() override;
+
+    /*
+      Compute the state that results from applying op to predecessor. If
+      the filter does not contain it yet, add and register it. Otherwise,
+      return tl::nullopt without registering the state.
+    */
+    virtual tl::optional<GlobalState> try_get_successor_state(
+        const GlobalState &predecessor, const OperatorProxy &op) override;
+
+    virtual void retain_state(StateID id) override;
+    virtual void release_state(StateID id) override;
+    virtual bool is_released(StateID id) const override {
+        return state_slots[id.value] == RELEASED;
+    }
+
+    virtual GlobalState get_successor_state(
+        const GlobalState &predecessor, const OperatorProxy &op) override;
+    virtual GlobalState insert_state(const PackedStateBin *buffer) override;
+    virtual StateID find_state(const PackedStateBin *buffer) override;
+
+    virtual void print_statistics() const override;
+};
+
+extern void add_bitstate_options_to_parser(options::OptionParser &parser);
+
+/*
+  Report an input error if the parsed options ask for a bitstate registry
+  together with options that it does not support.
+*/
+extern void verify_bitstate_options(
+    options::OptionParser &parser, const options::Options &opts);
+
+/*
+  Return a bitstate registry if the options ask for one and nullptr
+  otherwise.
+*/
+extern std::unique_ptr<StateRegistry> create_bitstate_state_registry(
+    const TaskProxy &task_proxy, const options::Options &opts,
+    const std::shared_ptr<mapped_file_arena::MappedFileArena> &arena);
+
+#endif
@@ -0,0 +1,284 @@
+#include "compressed_state_registry.h"
+
+#include "option_parser.h"
+#include "task_proxy.h"
+
+#include "utils/logging.h"
+#include "utils/memory.h"
+#include "utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+/*
+  Table of distinct arrays of entry_size bins which assigns dense IDs to
+  its entries.
+*/
+class CompressedStateRegistry::DataTable {
+    using Key = StateID::value_type;
+
+    /*
+      Placeholder ID for the entry in probe_entry. This allows looking up
+      entries in the hash set before adding them to the table.
+    */
+    static const Key PROBE_ID = numeric_limits<Key>::max();
+
+    struct EntryHash {
+        const DataTable &table;
+        explicit EntryHash(const DataTable &table)
+            : table(table) {
+        }
+
+        HashType operator()(Key id) const {
+            return StateRegistry::hash_state_data(
+                table.get_entry(id), table.entry_size);
+        }
+    };
+
+    struct EntryEqual {
+        const DataTable &table;
+        explicit EntryEqual(const DataTable &table)
+            : table(table) {
+        }
+
+        bool operator()(Key lhs, Key rhs) const {
+            const PackedStateBin *lhs_data = table.get_entry(lhs);
+            const PackedStateBin *rhs_data = table.get_entry(rhs);
+            return equal(lhs_data, lhs_data + table.entry_size, rhs_data);
+        }
+    };
+
+    using EntrySet = StateIDHashSet<EntryHash, EntryEqual>;
+
+    const int entry_size;
+    StateDataPool entries;
+    EntrySet entry_ids;
+    const PackedStateBin *probe_entry;
+
+    const PackedStateBin *get_entry(Key id) const {
+        if (id == PROBE_ID) {
+            assert(probe_entry);
+            return probe_entry;
+        }
+        return entries[id];
+    }
+public:
+    DataTable(
+        int entry_size,
+        const shared_ptr<mapped_file_arena::MappedFileArena> &arena)
+        : entry_size(entry_size),
+          entries(
+              entry_size,
+              mapped_file_arena::ArenaAllocator<PackedStateBin>(arena)),
+          entry_ids(EntryHash(*this), EntryEqual(*this)),
+          probe_entry(nullptr) {
+    }
+
+    // Return the ID of the given entry or -1 if the table does not contain it.
+    Key find(const PackedStateBin *entry, HashType hash) {
+        probe_entry = entry;
+        Key id = entry_ids.find(PROBE_ID, hash);
+        probe_entry = nullptr;
+        return id;
+    }
+
+    Key find(const PackedStateBin *entry) {
+        return find(entry, hash_state_data(entry, entry_size));
+    }
+
+    // Return the ID of the given entry and add the entry if it is new.
+    Key insert(const PackedStateBin *entry) {
+        HashType hash = hash_state_data(entry, entry_size);
+        Key id = find(entry, hash);
+        if (id == -1) {
+            id = entries.size();
+            if (id == PROBE_ID) {
+                cerr << "Compressed state registry exceeded the maximum "
+                     << "number of entries." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+            }
+            entries.push_back(entry);
+            entry_ids.insert(id, hash);
+        }
+        return id;
+    }
+
+    const PackedStateBin *operator[](Key id) const {
+        return entries[id];
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    void print_statistics() const {
+        entry_ids.print_statistics();
+    }
+};
+
+const StateID::value_type CompressedStateRegistry::DataTable::PROBE_ID;
+
+
+CompressedStateRegistry::CompressedStateRegistry(
+    const TaskProxy &task_proxy,
+    const shared_ptr<mapped_file_arena::MappedFileArena> &arena)
+    : StateRegistry(task_proxy, false, true),
+      num_bins(get_bins_per_state()),
+      successor_buffer(num_bins),
+      level_buffer(num_bins),
+      decompressed_id(StateID::no_state),
+      decompressed_data(num_bins) {
+    level_sizes.push_back(num_bins);
+    while (level_sizes.back() > 2) {
+        level_sizes.push_back((level_sizes.back() + 1) / 2);
+    }
+    nodes = utils::make_unique_ptr<DataTable>(2, arena);
+    roots = utils::make_unique_ptr<DataTable>(get_root_size(), arena);
+}
+
+CompressedStateRegistry::~CompressedStateRegistry() {
+}
+
+StateID CompressedStateRegistry::compress(const PackedStateBin *buffer) {
+    /*
+      Replace the entries of each level by the entries of the next level in
+      place: entry i of the next level only depends on entries 2i and 2i + 1.
+    */
+    copy(buffer, buffer + num_bins, level_buffer.begin());
+    for (size_t level = 1; level < level_sizes.size(); ++level) {
+        int num_children = level_sizes[level - 1];
+        for (int i = 0; i < level_sizes[level]; ++i) {
+            if (2 * i + 1 < num_children) {
+                StateID::value_type node = nodes->insert(&level_buffer[2 * i]);
+                if (static_cast<uint64_t>(node) >
+                    numeric_limits<PackedStateBin>::max()) {
+                    cerr << "Compressed state registry exceeded the maximum "
+                         << "number of nodes." << endl;
+                    utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+                }
+                level_buffer[i] = node;
+            } else {
+                // The last entry of a level with odd size has no sibling.
+                level_buffer[i] = level_buffer[2 * i];
+            }
+        }
+    }
+    StateID id(roots->insert(level_buffer.data()));
+    num_states.store(roots->size(), memory_order_relaxed);
+    return id;
+}
+
+void CompressedStateRegistry::decompress(
+    StateID id, PackedStateBin *buffer) const {
+    const PackedStateBin *root = (*roots)[id.value];
+    copy(root, root + get_root_size(), buffer);
+    /*
+      Expand the entries of each level back to front, so that we never
+      overwrite entries that we still need.
+    */
+    for (size_t level = level_sizes.size() - 1; level > 0; --level) {
+        int num_children = level_sizes[level - 1];
+        for (int i = level_sizes[level] - 1; i >= 0; --i) {
+            if (2 * i + 1 < num_children) {
+                const PackedStateBin *node = (*nodes)[buffer[i]];
+                buffer[2 * i] = node[0];
+                buffer[2 * i + 1] = node[1];
+            } else {
+                buffer[2 * i] = buffer[i];
+            }
+        }
+    }
+}
+
+const PackedStateBin *CompressedStateRegistry::decompress_state_data(
+    StateID id) const {
+    if (id != decompressed_id) {
+        decompress(id, decompressed_data.data());
+        decompressed_id = id;
+    }
+    return decompressed_data.data();
+}
+
+GlobalState CompressedStateRegistry::lookup_stored_state(StateID id) const {
+    return GlobalState((*roots)[id.value], *this, id);
+}
+
+GlobalState CompressedStateRegistry::register_initial_state() {
+    vector<PackedStateBin> buffer(num_bins);
+    pack_initial_state(buffer.data());
+    return insert_state(buffer.data());
+}
+
+GlobalState CompressedStateRegistry::get_successor_state(
+    const GlobalState &predecessor, const OperatorProxy &op) {
+    compute_successor_data(predecessor, op, successor_buffer.data());
+    size_t num_states_before = size();
+    GlobalState successor = insert_state(successor_buffer.data());
+    count_successor(size() == num_states_before);
+    return successor;
+}
+
+GlobalState CompressedStateRegistry::insert_state(const PackedStateBin *buffer) {
+    return lookup_stored_state(compress(buffer));
+}
+
+StateID CompressedStateRegistry::find_state(const PackedStateBin *buffer) {
+    // Like compress(), but stop as soon as an entry is missing.
+    copy(buffer, buffer + num_bins, level_buffer.begin());
+    for (size_t level = 1; level < level_sizes.size(); ++level) {
+        int num_children = level_sizes[level - 1];
+        for (int i = 0; i < level_sizes[level]; ++i) {
+            if (2 * i + 1 < num_children) {
+                StateID::value_type node = nodes->find(&level_buffer[2 * i]);
+                if (node == -1) {
+                    return StateID::no_state;
+                }
+                level_buffer[i] = node;
+            } else {
+                level_buffer[i] = level_buffer[2 * i];
+            }
+        }
+    }
+    StateID::value_type id = roots->find(level_buffer.data());
+    if (id == -1) {
+        return StateID::no_state;
+    }
+    return StateID(id);
+}
+
+void CompressedStateRegistry::print_statistics() const {
+    utils::g_log << "Number of registered states: " << size() << endl;
+    print_successor_statistics();
+    utils::g_log << "Compressed state nodes: " << nodes->size() << endl;
+    size_t num_bytes = (roots->size() * get_root_size() + nodes->size() * 2) *
+        sizeof(PackedStateBin);
+    utils::g_log << "State data bytes per state: "
+                 << (size() ? static_cast<double>(num_bytes) / size() : 0)
+                 << " (uncompressed: " << get_state_size_in_bytes() << ")"
+                 << endl;
+    roots->print_statistics();
+}
+
+void add_state_compression_option_to_parser(OptionParser &parser) {
+    vector<string> compression_methods;
+    vector<string> compression_methods_doc;
+    compression_methods.push_back("none");
+    compression_methods_doc.push_back(
+        "store the packed data of each state");
+    compression_methods.push_back("tree");
+    compression_methods_doc.push_back(
+        "store each state as a tree of pairs of bins that is shared with "
+        "other states. This needs much less memory per state for tasks "
+        "with many bins per state, but looking up states is slower. "
+        "Cannot be combined with state_hashing=zobrist");
+    parser.add_enum_option<StateCompression>(
+        "state_compression",
+        compression_methods,
+        "Compression of the state data stored for registered states.",
+        "none",
+        compression_methods_doc);
+}
@@ -0,0 +1,81 @@
+#ifndef COMPRESSED_STATE_REGISTRY_H
+#define COMPRESSED_STATE_REGISTRY_H
+
+#include "state_registry.h"
+
+#include <memory>
+#include <vector>
+
+namespace options {
+class OptionParser;
+}
+
+enum class StateCompression {
+    NONE,
+    TREE
+};
+
+/*
+  A state registry that stores the packed state data with tree
+  compression, as used in explicit-state model checkers.
+
+  We pair up adjacent bins of a state and replace each pair by the ID of
+  the pair in a table of distinct pairs. We repeat this for the resulting
+  sequence of IDs until at most two IDs remain, which we store as the
+  root of the state. Since most successors only differ from their parent
+  in a few variables, they share most subtrees with their parent, so
+  each new state usually adds its root and a few pairs, regardless of
+  the number of bins per state. Duplicate detection only compares roots,
+  because equal states have equal roots.
+
+  In return, reading the values of a state has to decompress it. The
+  GlobalStates of this registry point to the root of their state, and we
+  decompress it on access, keeping the data of the last decompressed state
+  since the search usually reads the same state several times in a row.
+  The registry uses StateHashing::PACKED_DATA for all tables and does not
+  support StateHashing::ZOBRIST.
+*/
+class CompressedStateRegistry : public StateRegistry {
+    class DataTable;
+
+    const int num_bins;
+    // Number of entries on each level of the tree, from the bins to the root.
+    std::vector<int> level_sizes;
+    std::unique_ptr<DataTable> nodes;
+    std::unique_ptr<DataTable> roots;
+
+    std::vector<PackedStateBin> successor_buffer;
+    std::vector<PackedStateBin> level_buffer;
+
+    // The last state that decompress_state_data() expanded and its data.
+    mutable StateID decompressed_id;
+    mutable std::vector<PackedStateBin> decompressed_data;
+
+    int get_root_size() const {
+        return level_sizes.back();
+    }
+
+    StateID compress(const PackedStateBin *buffer);
+    void decompress(StateID id, PackedStateBin *buffer) const;
+protected:
+    virtual const PackedStateBin *decompress_state_data(StateID id) const override;
+    virtual GlobalState lookup_stored_state(StateID id) const override;
+    virtual GlobalState register_initial_state() override;
+public:
+    // If arena is given, the tables are stored in its memory-mapped file.
+    explicit CompressedStateRegistry(
+        const TaskProxy &task_proxy,
+        const std::shared_ptr<mapped_file_arena::MappedFileArena> &arena = nullptr);
+    virtual ~CompressedStateRegistry() override;
+
+    virtual GlobalState get_successor_state(
+        const GlobalState &predecessor, const OperatorProxy &op) override;
+    virtual GlobalState insert_state(const PackedStateBin *buffer) override;
+    virtual StateID find_state(const PackedStateBin *buffer) override;
+
+    virtual void print_statistics() const override;
+};
+
+extern void add_state_compression_option_to_parser(options::OptionParser &parser);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef CONCURRENT_PER_STATE_INFORMATION_H
+#define CONCURRENT_PER_STATE_INFORMATION_H
+
+#include "global_state.h"
+#include "state_id.h"
+#include "state_registry.h"
+
+#include "algorithms/concurrent_segmented_vector.h"
+#include "utils/language.h"
+
+#include <cassert>
+
+/*
+  ConcurrentPerStateInformation associates information with the states of
+  a single state registry that is shared by several threads (see
+  concurrent_state_registry.h). Like PerStateInformation, looking up a
+  state that has no information yet returns a default value.
+
+  Different threads may access the entries of different states at the same
+  time without locking. The entry of a given state must only be accessed by
+  one thread at a time, e.g., because every state is owned by one thread.
+
+  Unlike PerStateInformation, this class does not subscribe to the registry,
+  so it must not outlive the registry of its states.
+*/
+template<class Entry>
+class ConcurrentPerStateInformation {
+    const Entry default_value;
+    segmented_vector::ConcurrentSegmentedArrayVector<Entry> entries;
+    const StateRegistryBase &registry;
+
+public:
+    explicit ConcurrentPerStateInformation(
+        const StateRegistryBase &registry, const Entry &default_value = Entry())
+        : default_value(default_value),
+          entries(1),
+          registry(registry) {
+        utils::unused_variable(this->registry);
+    }
+
+    ConcurrentPerStateInformation(const ConcurrentPerStateInformation<Entry> &) = delete;
+    ConcurrentPerStateInformation &operator=(const ConcurrentPerStateInformation<Entry> &) = delete;
+
+    Entry &operator[](const GlobalState &state) {
+        assert(&state.get_registry() == &registry);
+        return *entries.get_or_add(state.get_id().value, &default_value);
+    }
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include "concurrent_state_registry.h"
+
+#include "task_proxy.h"
+
+#include "task_utils/task_properties.h"
+#include "utils/logging.h"
+#include "utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+struct ConcurrentStateRegistry::Shard {
+    /*
+      Placeholder ID for the state data in probe_data. This allows looking up
+      states in the hash set before assigning them an ID.
+    */
+    static const StateID::value_type PROBE_ID =
+        numeric_limits<StateID::value_type>::max();
+
+    struct StateIDSemanticHash {
+        const Shard &shard;
+        explicit StateIDSemanticHash(const Shard &shard)
+            : shard(shard) {
+        }
+
+        HashType operator()(StateID::value_type id) const {
+            return hash_state_data(
+                shard.get_data(id), shard.num_bins);
+        }
+    };
+
+    struct StateIDSemanticEqual {
+        const Shard &shard;
+        explicit StateIDSemanticEqual(const Shard &shard)
+            : shard(shard) {
+        }
+
+        bool operator()(StateID::value_type lhs, StateID::value_type rhs) const {
+            const PackedStateBin *lhs_data = shard.get_data(lhs);
+            const PackedStateBin *rhs_data = shard.get_data(rhs);
+            return equal(lhs_data, lhs_data + shard.num_bins, rhs_data);
+        }
+    };
+
+    using StateIDSet = StateIDHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
+
+    const segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin> &state_data_pool;
+    const int num_bins;
+
+    // Guards all members below.
+    mutex shard_mutex;
+    StateIDSet registered_states;
+    const PackedStateBin *probe_data;
+
+    Shard(const segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin> &state_data_pool,
+          int num_bins)
+        : state_data_pool(state_data_pool),
+          num_bins(num_bins),
+          registered_states(StateIDSemanticHash(*this), StateIDSemanticEqual(*this)),
+          probe_data(nullptr) {
+    }
+
+    const PackedStateBin *get_data(StateID::value_type id) const {
+        if (id == PROBE_ID) {
+            assert(probe_data);
+            return probe_data;
+        }
+        return state_data_pool[id];
+    }
+};
+
+const StateID::value_type ConcurrentStateRegistry::Shard::PROBE_ID;
+
+
+ConcurrentStateRegistry::ConcurrentStateRegistry(
+    const TaskProxy &task_proxy, int num_shards)
+    : StateRegistryBase(task_proxy),
+      num_bins(get_bins_per_state()),
+      state_data_pool(num_bins),
+      has_axioms(task_properties::has_axioms(task_proxy)) {
+    assert(num_shards >= 1);
+    shards.reserve(num_shards);
+    for (int i = 0; i < num_shards; ++i) {
+        shards.push_back(utils::make_unique_ptr<Shard>(state_data_pool, num_bins));
+    }
+}
+
+ConcurrentStateRegistry::~ConcurrentStateRegistry() {
+}
+
+ConcurrentStateRegistry::Shard &ConcurrentStateRegistry::get_shard(
+    HashType hash) const {
+    /*
+      IntHashSet uses the low bits of the hash to choose a bucket, so we use
+      the high bits to choose the shard. Otherwise, all states of a shard
+      would end up in a fraction of its buckets.
+    */
+    uint64_t high_bits = hash >> (numeric_limits<HashType>::digits - 32);
+    int shard = (high_bits * shards.size()) >> 32;
+    return *shards[shard];
+}
+
+const GlobalState &ConcurrentStateRegistry::get_initial_state() {
+    lock_guard<mutex> lock(initial_state_mutex);
+    if (!cached_initial_state) {
+        vector<PackedStateBin> buffer(num_bins);
+        pack_initial_state(buffer.data());
+        cached_initial_state = utils::make_unique_ptr<GlobalState>(
+            insert_state(buffer.data()));
+    }
+    return *cached_initial_state;
+}
+
+GlobalState ConcurrentStateRegistry::get_successor_state(
+    const GlobalState &predecessor, const OperatorProxy &op) {
+    static thread_local vector<PackedStateBin> buffer;
+    buffer.resize(num_bins);
+    compute_successor_data(predecessor, op, buffer.data());
+    return insert_state(buffer.data());
+}
+
+void ConcurrentStateRegistry::compute_successor_data(
+    const GlobalState &predecessor, const OperatorProxy &op,
+    PackedStateBin *buffer) {
+    unique_lock<mutex> lock(axiom_mutex, defer_lock);
+    if (has_axioms) {
+        lock.lock();
+    }
+    write_successor_data(predecessor, op, buffer);
+}
+
+GlobalState ConcurrentStateRegistry::insert_state(const PackedStateBin *buffer) {
+    HashType hash = hash_state_data(buffer, num_bins);
+    Shard &shard = get_shard(hash);
+    StateID::value_type id;
+    {
+        lock_guard<mutex> lock(shard.shard_mutex);
+        shard.probe_data = buffer;
+        id = shard.registered_states.find(Shard::PROBE_ID, hash);
+        if (id == -1) {
+            id = num_states.fetch_add(1, memory_order_relaxed);
+            assert(id != Shard::PROBE_ID);
+            state_data_pool.set(id, buffer);
+            shard.registered_states.insert(id, hash);
+        }
+        shard.probe_data = nullptr;
+    }
+    return lookup_state(StateID(id));
+}
+
+StateID ConcurrentStateRegistry::find_state(const PackedStateBin *buffer) {
+    HashType hash = hash_state_data(buffer, num_bins);
+    Shard &shard = get_shard(hash);
+    lock_guard<mutex> lock(shard.shard_mutex);
+    shard.probe_data = buffer;
+    StateID::value_type id = shard.registered_states.find(Shard::PROBE_ID, hash);
+    shard.probe_data = nullptr;
+    if (id == -1) {
+        return StateID::no_state;
+    }
+    return StateID(id);
+}
+
+void ConcurrentStateRegistry::print_statistics() const {
+    utils::g_log << "Number of registered states: " << size() << endl;
+    utils::g_log << "State data bytes per state: "
+                 << get_state_size_in_bytes() << endl;
+    size_t min_shard_size = numeric_limits<size_t>::max();
+    size_t max_shard_size = 0;
+    for (const unique_ptr<Shard> &shard : shards) {
+        min_shard_size = min(min_shard_size, shard->registered_states.size());
+        max_shard_size = max(max_shard_size, shard->registered_states.size());
+    }
+    utils::g_log << "State registry shards: " << shards.size()
+                 << " (smallest: " << min_shard_size
+                 << ", largest: " << max_shard_size << ")" << endl;
+}
@@ -0,0 +1,79 @@
+#ifndef CONCURRENT_STATE_REGISTRY_H
+#define CONCURRENT_STATE_REGISTRY_H
+
+#include "state_registry.h"
+
+#include "algorithms/concurrent_segmented_vector.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+  A state registry that can be shared by several threads.
+
+  get_initial_state(), get_successor_state(), compute_successor_data(),
+  insert_state(), find_state(), lookup_state() and size() may be called
+  concurrently, and
+  the GlobalStates they return can be used by all threads. State IDs are
+  globally unique and stable, and they are dense: the registered states have
+  IDs 0, ..., size() - 1. Which ID a state receives depends on the order in
+  which the threads register states.
+
+  The state data of all states is stored in a single
+  ConcurrentSegmentedArrayVector, which can be read without locking. For
+  duplicate detection, the states are partitioned into shards by their hash
+  value. Each shard has its own hash set of state IDs which is protected by
+  its own mutex, so threads only contend when they register states of the
+  same shard at the same time. A new state is only assigned an ID after
+  checking that it is not registered yet, so we never have to undo the
+  registration of a duplicate.
+
+  Evaluating axioms is not thread-safe, so for tasks with axioms successor
+  states are computed one at a time.
+
+  Note that subscribing to the registry is not thread-safe. In particular,
+  each PerStateInformation (and similar classes) should only be used by a
+  single thread, or the accesses have to be synchronized. Iterating over the
+  registry and print_statistics() are only safe while no thread registers
+  states.
+*/
+class ConcurrentStateRegistry : public StateRegistryBase {
+    struct Shard;
+
+    const int num_bins;
+    segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin> state_data_pool;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    const bool has_axioms;
+    std::mutex axiom_mutex;
+
+    std::mutex initial_state_mutex;
+    std::unique_ptr<GlobalState> cached_initial_state;
+
+    Shard &get_shard(HashType hash) const;
+public:
+    ConcurrentStateRegistry(const TaskProxy &task_proxy, int num_shards);
+    virtual ~ConcurrentStateRegistry() override;
+
+    /*
+      The following methods behave like the methods of StateRegistry with
+      the same names. While other threads register states, size() may
+      include states whose registration has not been completed yet.
+    */
+    GlobalState lookup_state(StateID id) const {
+        return GlobalState(state_data_pool[id.value], *this, id);
+    }
+    const GlobalState &get_initial_state();
+    GlobalState get_successor_state(
+        const GlobalState &predecessor, const OperatorProxy &op);
+    void compute_successor_data(
+        const GlobalState &predecessor, const OperatorProxy &op,
+        PackedStateBin *buffer);
+    GlobalState insert_state(const PackedStateBin *buffer);
+    StateID find_state(const PackedStateBin *buffer);
+
+    void print_statistics() const;
+};
+
+#endif
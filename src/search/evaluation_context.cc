@@ -21,14 +21,23 @@ EvaluationContext::EvaluationContext(
 
 EvaluationContext::EvaluationContext(
     const GlobalState &state, int g_value, bool is_preferred,
-    SearchStatistics *statistics, bool calculate_preferred)
-    : EvaluationContext(EvaluatorCache(state), g_value, is_preferred, statistics, calculate_preferred) {
+    SearchStatistics *statistics, bool calculate_preferred,
+    PreferredOperatorsPool *pool)
+    : cache(state, pool),
+      g_value(g_value),
+      preferred(is_preferred),
+      statistics(statistics),
+      calculate_preferred(calculate_preferred) {
 }
 
 EvaluationContext::EvaluationContext(
     const GlobalState &state,
     SearchStatistics *statistics, bool calculate_preferred)
-    : EvaluationContext(EvaluatorCache(state), INVALID, false, statistics, calculate_preferred) {
+    : cache(state),
+      g_value(INVALID),
+      preferred(false),
+      statistics(statistics),
+      calculate_preferred(calculate_preferred) {
 }
 
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
@@ -44,6 +53,33 @@ const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     return result;
 }
 
+void EvaluationContext::compute_results(
+    const vector<EvaluationContext *> &eval_contexts, Evaluator *evaluator) {
+    vector<EvaluationContext *> missing_contexts;
+    for (EvaluationContext *eval_context : eval_contexts) {
+        if (eval_context->cache[evaluator].is_uninitialized()) {
+            missing_contexts.push_back(eval_context);
+        }
+    }
+    if (missing_contexts.empty()) {
+        return;
+    }
+    vector<EvaluationResult> results =
+        evaluator->compute_results(missing_contexts);
+    assert(results.size() == missing_contexts.size());
+    for (size_t i = 0; i < missing_contexts.size(); ++i) {
+        EvaluationContext &eval_context = *missing_contexts[i];
+        EvaluationResult &result = eval_context.cache[evaluator];
+        assert(result.is_uninitialized());
+        result = move(results[i]);
+        if (eval_context.statistics &&
+            evaluator->is_used_for_counting_evaluations() &&
+            result.get_count_evaluation()) {
+            eval_context.statistics->inc_evaluations();
+        }
+    }
+}
+
 const EvaluatorCache &EvaluationContext::get_cache() const {
     return cache;
 }
@@ -85,3 +121,7 @@ EvaluationContext::get_preferred_operators(Evaluator *eval) {
 bool EvaluationContext::get_calculate_preferred() const {
     return calculate_preferred;
 }
+
+vector<OperatorID> EvaluationContext::acquire_preferred_operators_vector() {
+    return cache.acquire_preferred_operators_vector();
+}
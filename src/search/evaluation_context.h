@@ -5,7 +5,7 @@
 #include "evaluator_cache.h"
 #include "operator_id.h"
 
-#include <unordered_map>
+#include <vector>
 
 class Evaluator;
 class GlobalState;
@@ -61,11 +61,13 @@ public:
         SearchStatistics *statistics, bool calculate_preferred = false);
     /*
       Create new heuristic cache for caching heuristic values. Used for example
-      by eager search.
+      by eager search. If a pool is given, the cache recycles the vectors of
+      preferred operators with it.
     */
     EvaluationContext(
         const GlobalState &state, int g_value, bool is_preferred,
-        SearchStatistics *statistics, bool calculate_preferred = false);
+        SearchStatistics *statistics, bool calculate_preferred = false,
+        PreferredOperatorsPool *pool = nullptr);
     /*
       Use the following constructor when you don't care about g values,
       preferredness (and statistics), e.g. when sampling states for heuristics.
@@ -82,9 +84,22 @@ public:
         const GlobalState &state,
         SearchStatistics *statistics = nullptr, bool calculate_preferred = false);
 
+    EvaluationContext(const EvaluationContext &other) = default;
+    EvaluationContext(EvaluationContext &&other) = default;
     ~EvaluationContext() = default;
 
+    EvaluationContext &operator=(const EvaluationContext &other) = default;
+    EvaluationContext &operator=(EvaluationContext &&other) = default;
+
     const EvaluationResult &get_result(Evaluator *eval);
+
+    /*
+      Compute the results of eval for all given contexts that do not have
+      a result for it yet with a single call to Evaluator::compute_results
+      and cache them in the contexts.
+    */
+    static void compute_results(
+        const std::vector<EvaluationContext *> &eval_contexts, Evaluator *eval);
     const EvaluatorCache &get_cache() const;
     const GlobalState &get_state() const;
     int get_g_value() const;
@@ -106,6 +121,12 @@ public:
     int get_evaluator_value_or_infinity(Evaluator *eval);
     const std::vector<OperatorID> &get_preferred_operators(Evaluator *eval);
     bool get_calculate_preferred() const;
+
+    /*
+      Return an empty vector that evaluators can use for the preferred
+      operators of their result. It is recycled if the cache has a pool.
+    */
+    std::vector<OperatorID> acquire_preferred_operators_vector();
 };
 
 #endif
@@ -4,7 +4,9 @@ using namespace std;
 
 const int EvaluationResult::INFTY = numeric_limits<int>::max();
 
-EvaluationResult::EvaluationResult() : evaluator_value(UNINITIALIZED) {
+EvaluationResult::EvaluationResult()
+    : evaluator_value(UNINITIALIZED),
+      count_evaluation(false) {
 }
 
 bool EvaluationResult::is_uninitialized() const {
@@ -36,6 +38,12 @@ void EvaluationResult::set_preferred_operators(
     preferred_operators = move(preferred_ops);
 }
 
+vector<OperatorID> EvaluationResult::take_preferred_operators() {
+    vector<OperatorID> result = move(preferred_operators);
+    preferred_operators.clear();
+    return result;
+}
+
 void EvaluationResult::set_count_evaluation(bool count_eval) {
     count_evaluation = count_eval;
 }
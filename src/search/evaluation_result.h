@@ -46,6 +46,8 @@ public:
 
     void set_evaluator_value(int value);
     void set_preferred_operators(std::vector<OperatorID> &&preferred_operators);
+    // Move the preferred operators out of the result, e.g., to recycle them.
+    std::vector<OperatorID> take_preferred_operators();
     void set_count_evaluation(bool count_eval);
 };
 
@@ -18,13 +18,28 @@ Evaluator::Evaluator(const string &description,
     : description(description),
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
-      use_for_counting_evaluations(use_for_counting_evaluations) {
+      use_for_counting_evaluations(use_for_counting_evaluations),
+      cache_slot(-1) {
 }
 
 bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+void Evaluator::get_involved_evaluators(set<Evaluator *> &evals) {
+    evals.insert(this);
+}
+
+vector<EvaluationResult> Evaluator::compute_results(
+    const vector<EvaluationContext *> &eval_contexts) {
+    vector<EvaluationResult> results;
+    results.reserve(eval_contexts.size());
+    for (EvaluationContext *eval_context : eval_contexts) {
+        results.push_back(compute_result(*eval_context));
+    }
+    return results;
+}
+
 void Evaluator::report_value_for_initial_state(const EvaluationResult &result) const {
     assert(use_for_reporting_minima);
     utils::g_log << "Initial heuristic value for " << description << ": ";
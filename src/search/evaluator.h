@@ -4,6 +4,7 @@
 #include "evaluation_result.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class GlobalState;
@@ -13,6 +14,8 @@ class Evaluator {
     const bool use_for_reporting_minima;
     const bool use_for_boosting;
     const bool use_for_counting_evaluations;
+    // Index of the inline entry for this evaluator in EvaluatorCache.
+    int cache_slot;
 
 public:
     Evaluator(
@@ -43,6 +46,16 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      get_involved_evaluators should insert this evaluator and all
+      evaluators whose results it directly or indirectly looks up in the
+      evaluation context into the result set. Search engines use this to
+      assign cache slots (see EvaluatorCache::assign_slots).
+
+      The default implementation only inserts this evaluator.
+    */
+    virtual void get_involved_evaluators(std::set<Evaluator *> &evals);
+
 
     virtual void notify_initial_state(const GlobalState & /*initial_state*/) {
     }
@@ -76,6 +89,20 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) = 0;
 
+    /*
+      compute_results should compute the results for a batch of
+      evaluation contexts and return them in the same order. Eager search
+      uses it to evaluate the new successors of an expansion at once
+      (see EvaluationContext::compute_results), so that evaluators can
+      share work between the states of a batch. The default
+      implementation calls compute_result for each context.
+
+      As for compute_result, the results should not be added to the
+      evaluation contexts.
+    */
+    virtual std::vector<EvaluationResult> compute_results(
+        const std::vector<EvaluationContext *> &eval_contexts);
+
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
@@ -84,6 +111,14 @@ public:
     bool is_used_for_boosting() const;
     bool is_used_for_counting_evaluations() const;
 
+    int get_cache_slot() const {
+        return cache_slot;
+    }
+
+    void set_cache_slot(int slot) {
+        cache_slot = slot;
+    }
+
     virtual bool does_cache_estimates() const;
     virtual bool is_estimate_cached(const GlobalState &state) const;
     /*
@@ -1,16 +1,144 @@
 #include "evaluator_cache.h"
 
+#include "evaluator.h"
+
+#include <cassert>
+
 using namespace std;
 
+// Maximal number of vectors kept by a PreferredOperatorsPool.
+static const size_t MAX_POOLED_VECTORS = 64;
+
+
+vector<OperatorID> PreferredOperatorsPool::acquire() {
+    if (vectors.empty()) {
+        return vector<OperatorID>();
+    }
+    vector<OperatorID> result = move(vectors.back());
+    vectors.pop_back();
+    assert(result.empty());
+    return result;
+}
+
+void PreferredOperatorsPool::release(vector<OperatorID> &&preferred_operators) {
+    if (preferred_operators.capacity() > 0 && vectors.size() < MAX_POOLED_VECTORS) {
+        preferred_operators.clear();
+        vectors.push_back(move(preferred_operators));
+    }
+}
+
+
+EvaluatorCache::EvaluatorCache(
+    const GlobalState &state, PreferredOperatorsPool *pool)
+    : state(state),
+      pool(pool) {
+    slot_evaluators.fill(nullptr);
+}
+
+EvaluatorCache::EvaluatorCache(const EvaluatorCache &other)
+    : slot_evaluators(other.slot_evaluators),
+      state(other.state),
+      pool(other.pool) {
+    for (int slot = 0; slot < NUM_SLOTS; ++slot) {
+        if (slot_evaluators[slot]) {
+            copy_result(other.slot_results[slot], slot_results[slot]);
+        }
+    }
+    for (const auto &element : other.other_results) {
+        other_results.emplace_back(element.first, EvaluationResult());
+        copy_result(element.second, other_results.back().second);
+    }
+}
+
+EvaluatorCache::~EvaluatorCache() {
+    release_preferred_operators();
+}
+
+EvaluatorCache &EvaluatorCache::operator=(const EvaluatorCache &other) {
+    return *this = EvaluatorCache(other);
+}
+
+EvaluatorCache &EvaluatorCache::operator=(EvaluatorCache &&other) {
+    release_preferred_operators();
+    slot_evaluators = other.slot_evaluators;
+    slot_results = move(other.slot_results);
+    other_results = move(other.other_results);
+    state = move(other.state);
+    pool = other.pool;
+    return *this;
+}
+
+void EvaluatorCache::copy_result(
+    const EvaluationResult &from, EvaluationResult &to) {
+    const vector<OperatorID> &preferred_operators = from.get_preferred_operators();
+    if (!pool || preferred_operators.empty()) {
+        to = from;
+        return;
+    }
+    vector<OperatorID> copied_operators = pool->acquire();
+    copied_operators.assign(preferred_operators.begin(), preferred_operators.end());
+    to.set_evaluator_value(from.get_evaluator_value());
+    to.set_count_evaluation(from.get_count_evaluation());
+    to.set_preferred_operators(move(copied_operators));
+}
 
-EvaluatorCache::EvaluatorCache(const GlobalState &state)
-    : state(state) {
+void EvaluatorCache::release_preferred_operators() {
+    if (!pool) {
+        return;
+    }
+    for (int slot = 0; slot < NUM_SLOTS; ++slot) {
+        if (slot_evaluators[slot]) {
+            pool->release(slot_results[slot].take_preferred_operators());
+        }
+    }
+    for (auto &element : other_results) {
+        pool->release(element.second.take_preferred_operators());
+    }
 }
 
 EvaluationResult &EvaluatorCache::operator[](Evaluator *eval) {
-    return eval_results[eval];
+    int slot = eval->get_cache_slot();
+    if (slot != -1) {
+        assert(slot >= 0 && slot < NUM_SLOTS);
+        Evaluator *&slot_evaluator = slot_evaluators[slot];
+        if (!slot_evaluator) {
+            slot_evaluator = eval;
+        }
+        if (slot_evaluator == eval) {
+            return slot_results[slot];
+        }
+    }
+    for (auto &element : other_results) {
+        if (element.first == eval) {
+            return element.second;
+        }
+    }
+    other_results.emplace_back(eval, EvaluationResult());
+    return other_results.back().second;
 }
 
 const GlobalState &EvaluatorCache::get_state() const {
     return state;
 }
+
+vector<OperatorID> EvaluatorCache::acquire_preferred_operators_vector() {
+    if (pool) {
+        return pool->acquire();
+    }
+    return vector<OperatorID>();
+}
+
+void EvaluatorCache::assign_slots(const set<Evaluator *> &evaluators) {
+    set<Evaluator *> involved_evaluators;
+    for (Evaluator *evaluator : evaluators) {
+        evaluator->get_involved_evaluators(involved_evaluators);
+    }
+    int num_slots = 0;
+    for (Evaluator *evaluator : involved_evaluators) {
+        if (num_slots < NUM_SLOTS) {
+            evaluator->set_cache_slot(num_slots++);
+        } else {
+            evaluator->set_cache_slot(-1);
+        }
+    }
+}
@@ -3,36 +3,95 @@
 
 #include "evaluation_result.h"
 #include "global_state.h"
+#include "operator_id.h"
 
-#include <unordered_map>
+#include <array>
+#include <list>
+#include <set>
+#include <utility>
+#include <vector>
 
 class Evaluator;
 
-using EvaluationResults = std::unordered_map<Evaluator *, EvaluationResult>;
+/*
+  Recycle the vectors of preferred operators in evaluation results.
+  Caches that use a pool return the vectors of their results to it when
+  they are destroyed, and heuristics take new vectors from it, so a
+  search that evaluates many states reuses the same few vectors instead
+  of allocating new ones. Search engines own the pool of their contexts.
+  The pool is not thread-safe.
+*/
+class PreferredOperatorsPool {
+    std::vector<std::vector<OperatorID>> vectors;
+public:
+    // Return an empty vector, with some capacity if possible.
+    std::vector<OperatorID> acquire();
+    void release(std::vector<OperatorID> &&preferred_operators);
+};
+
 
 /*
   Store a state and evaluation results for this state.
+
+  Evaluators with a cache slot below NUM_SLOTS store their results in an
+  inline array, so creating and filling a cache needs no allocation.
+  Search engines assign dense slots to the evaluators they use (see
+  assign_slots). The results of all other evaluators, e.g., from an
+  earlier search of iterated search or from evaluators with the same
+  slot in the same cache, are stored in a list.
 */
 class EvaluatorCache {
-    EvaluationResults eval_results;
+public:
+    static const int NUM_SLOTS = 8;
+
+private:
+    std::array<Evaluator *, NUM_SLOTS> slot_evaluators;
+    std::array<EvaluationResult, NUM_SLOTS> slot_results;
+    // We use a list, since callers keep references to results.
+    std::list<std::pair<Evaluator *, EvaluationResult>> other_results;
     GlobalState state;
+    PreferredOperatorsPool *pool;
+
+    void copy_result(const EvaluationResult &from, EvaluationResult &to);
+    void release_preferred_operators();
 
 public:
-    explicit EvaluatorCache(const GlobalState &state);
-    ~EvaluatorCache() = default;
+    explicit EvaluatorCache(
+        const GlobalState &state, PreferredOperatorsPool *pool = nullptr);
+    EvaluatorCache(const EvaluatorCache &other);
+    EvaluatorCache(EvaluatorCache &&other) = default;
+    ~EvaluatorCache();
+
+    EvaluatorCache &operator=(const EvaluatorCache &other);
+    EvaluatorCache &operator=(EvaluatorCache &&other);
 
     EvaluationResult &operator[](Evaluator *eval);
 
     const GlobalState &get_state() const;
 
+    // Return an empty vector for preferred operators, recycled if possible.
+    std::vector<OperatorID> acquire_preferred_operators_vector();
+
     template<class Callback>
     void for_each_evaluator_result(const Callback &callback) const {
-        for (const auto &element : eval_results) {
+        for (int slot = 0; slot < NUM_SLOTS; ++slot) {
+            if (slot_evaluators[slot]) {
+                callback(slot_evaluators[slot], slot_results[slot]);
+            }
+        }
+        for (const auto &element : other_results) {
             const Evaluator *eval = element.first;
             const EvaluationResult &result = element.second;
             callback(eval, result);
         }
     }
+
+    /*
+      Assign dense cache slots to the given evaluators and the evaluators
+      involved in them (see Evaluator::get_involved_evaluators). Search
+      engines call this when they are initialized.
+    */
+    static void assign_slots(const std::set<Evaluator *> &evaluators);
 };
 
 #endif
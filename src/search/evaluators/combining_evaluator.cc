@@ -50,4 +50,10 @@ void CombiningEvaluator::get_path_dependent_evaluators(
     for (auto &subevaluator : subevaluators)
         subevaluator->get_path_dependent_evaluators(evals);
 }
+
+void CombiningEvaluator::get_involved_evaluators(set<Evaluator *> &evals) {
+    evals.insert(this);
+    for (auto &subevaluator : subevaluators)
+        subevaluator->get_involved_evaluators(evals);
+}
 }
@@ -42,6 +42,8 @@ public:
 
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) override;
+    virtual void get_involved_evaluators(
+        std::set<Evaluator *> &evals) override;
 };
 }
 
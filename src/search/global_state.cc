@@ -12,7 +12,8 @@ using namespace std;
 
 
 GlobalState::GlobalState(
-    const PackedStateBin *buffer, const StateRegistry &registry, StateID id)
+    const PackedStateBin *buffer, const StateRegistryBase &registry,
+    StateID id)
     : buffer(buffer),
       registry(&registry),
       id(id) {
@@ -23,14 +24,12 @@ GlobalState::GlobalState(
 int GlobalState::operator[](int var) const {
     assert(var >= 0);
     assert(var < registry->get_num_variables());
-    return registry->get_state_value(buffer, var);
+    return registry->get_state_value(*this, var);
 }
 
 State GlobalState::unpack() const {
-    int num_variables = registry->get_num_variables();
-    vector<int> values(num_variables);
-    for (int var = 0; var < num_variables; ++var)
-        values[var] = (*this)[var];
+    vector<int> values(registry->get_num_variables());
+    registry->unpack_state(*this, values.data());
     TaskProxy task_proxy = registry->get_task_proxy();
     return task_proxy.create_state(move(values));
 }
@@ -5,37 +5,52 @@
 
 #include "algorithms/int_packer.h"
 
+#include <memory>
+#include <vector>
+
 class State;
-class StateRegistry;
+class StateRegistryBase;
 
 using PackedStateBin = int_packer::IntPacker::Bin;
 
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 class GlobalState {
+    friend class BitstateStateRegistry;
+    friend class CompressedStateRegistry;
+    friend class ConcurrentStateRegistry;
     friend class StateRegistry;
+    friend class StateRegistryBase;
+    template<typename>
+    friend class ConcurrentPerStateInformation;
     template<typename Entry>
     friend class PerStateInformation;
     template<typename>
     friend class PerStateArray;
     friend class PerStateBitset;
 
-    // Values for vars are maintained in a packed state and accessed on demand.
+    /*
+      Values for vars are maintained in a packed state and accessed on demand.
+      Registries that compress their states (see CompressedStateRegistry)
+      point to the compressed data instead, so only the registry may read the
+      buffer directly (see StateRegistryBase::get_state_data).
+    */
     const PackedStateBin *buffer;
 
     // registry isn't a reference because we want to support operator=
-    const StateRegistry *registry;
+    const StateRegistryBase *registry;
     StateID id;
 
     // Only used by the state registry.
     GlobalState(
-        const PackedStateBin *buffer, const StateRegistry &registry, StateID id);
+        const PackedStateBin *buffer, const StateRegistryBase &registry,
+        StateID id);
 
     const PackedStateBin *get_packed_buffer() const {
         return buffer;
     }
 
-    const StateRegistry &get_registry() const {
+    const StateRegistryBase &get_registry() const {
         return *registry;
     }
 public:
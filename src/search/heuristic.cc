@@ -90,7 +90,12 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 #endif
 
     result.set_evaluator_value(heuristic);
-    result.set_preferred_operators(preferred_operators.pop_as_vector());
+    if (!preferred_operators.empty()) {
+        vector<OperatorID> storage =
+            eval_context.acquire_preferred_operators_vector();
+        result.set_preferred_operators(
+            preferred_operators.pop_as_vector(move(storage)));
+    }
     assert(preferred_operators.empty());
 
     return result;
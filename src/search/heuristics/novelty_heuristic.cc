@@ -0,0 +1,85 @@
+#include "novelty_heuristic.h"
+
+#include "../evaluation_context.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/novelty_table.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+using namespace std;
+
+namespace novelty_heuristic {
+NoveltyHeuristic::NoveltyHeuristic(const Options &opts)
+    : Heuristic(opts),
+      width(opts.get<int>("width")),
+      partition(opts.contains("partition") ?
+                opts.get<shared_ptr<Evaluator>>("partition") : nullptr) {
+    utils::g_log << "Initializing novelty heuristic with width " << width
+                 << "..." << endl;
+}
+
+NoveltyHeuristic::~NoveltyHeuristic() {
+}
+
+int NoveltyHeuristic::compute_heuristic(const GlobalState &global_state) {
+    int partition_value = 0;
+    if (partition) {
+        EvaluationContext eval_context(global_state);
+        partition_value = eval_context.get_evaluator_value_or_infinity(
+            partition.get());
+        if (partition_value == EvaluationResult::INFTY) {
+            return DEAD_END;
+        }
+    }
+    unique_ptr<novelty_table::NoveltyTable> &table = tables[partition_value];
+    if (!table) {
+        table = utils::make_unique_ptr<novelty_table::NoveltyTable>(
+            task_proxy, width);
+    }
+    State state = convert_global_state(global_state);
+    return table->compute_novelty_and_update(state.get_values());
+}
+
+static shared_ptr<Heuristic> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Novelty heuristic",
+        "Returns 1 for states with a fact that no earlier evaluated state "
+        "had, 2 for states with such a pair of facts (only for width 2) and "
+        "width + 1 otherwise. The tables of seen facts and fact pairs are "
+        "bitsets, so evaluating a state is much cheaper than a relaxed "
+        "exploration. To obtain best-first width search (BFWS), partition "
+        "the states by goal count and break ties by it, e.g., "
+        "tiebreaking([novelty(width=2, partition=goalcount()), goalcount()]).");
+    parser.document_language_support("action costs", "ignored");
+    parser.document_language_support("conditional effects", "supported");
+    parser.document_language_support("axioms", "supported");
+    parser.document_property("admissible", "no");
+    parser.document_property("consistent", "no");
+    parser.document_property("safe", "yes (unless the partition is not safe)");
+    parser.document_property("preferred operators", "no");
+    parser.document_note(
+        "Memory usage",
+        "For width 2, each partition needs n * (n - 1) / 2 bits for n facts.");
+
+    parser.add_option<int>(
+        "width",
+        "size of the largest fact tuples that are tracked",
+        "1",
+        Bounds("1", "2"));
+    parser.add_option<shared_ptr<Evaluator>>(
+        "partition",
+        "compute the novelty separately for the states with the same value "
+        "of this evaluator, which must not depend on g values",
+        OptionParser::NONE);
+    Heuristic::add_options_to_parser(parser);
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<NoveltyHeuristic>(opts);
+}
+
+static Plugin<Evaluator> _plugin("novelty", _parse);
+}
@@ -0,0 +1,37 @@
+#ifndef HEURISTICS_NOVELTY_HEURISTIC_H
+#define HEURISTICS_NOVELTY_HEURISTIC_H
+
+#include "../heuristic.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace novelty_table {
+class NoveltyTable;
+}
+
+namespace novelty_heuristic {
+/*
+  The novelty of a state is 1 if it is the first evaluated state with
+  one of its facts, 2 if it is the first one with one of its fact pairs
+  (width 2 only) and width + 1 otherwise. With a partition evaluator,
+  the novelty only considers the earlier states with the same value of
+  that evaluator, as in best-first width search (BFWS).
+
+  The estimate of a state depends on the states evaluated before it, so
+  we rely on the heuristic cache to return the same estimate if the
+  state is evaluated again.
+*/
+class NoveltyHeuristic : public Heuristic {
+    const int width;
+    std::shared_ptr<Evaluator> partition;
+    std::unordered_map<int, std::unique_ptr<novelty_table::NoveltyTable>> tables;
+protected:
+    virtual int compute_heuristic(const GlobalState &global_state) override;
+public:
+    explicit NoveltyHeuristic(const options::Options &opts);
+    virtual ~NoveltyHeuristic() override;
+};
+}
+
+#endif
@@ -81,6 +81,9 @@ public:
     */
     virtual void boost_preferred();
 
+    // Print statistics about the open list, if it collects any.
+    virtual void print_statistics() const;
+
     /*
       Add all path-dependent evaluators that this open lists uses (directly or
       indirectly) into the result set.
@@ -90,6 +93,15 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      Add all evaluators that this open list evaluates directly (i.e.,
+      not the subevaluators of these evaluators) into the result set.
+      Search engines use this to find the evaluators whose values they
+      compute, e.g., to set up the evaluator caches or to evaluate
+      several states at once before inserting them.
+    */
+    virtual void get_evaluators(std::set<Evaluator *> &evals) = 0;
+
     /*
       Accessor method for only_preferred.
 
@@ -142,6 +154,10 @@ template<class Entry>
 void OpenList<Entry>::boost_preferred() {
 }
 
+template<class Entry>
+void OpenList<Entry>::print_statistics() const {
+}
+
 template<class Entry>
 void OpenList<Entry>::insert(
     EvaluationContext &eval_context, const Entry &entry) {
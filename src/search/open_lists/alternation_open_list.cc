@@ -33,8 +33,10 @@ public:
     virtual bool empty() const override;
     virtual void clear() override;
     virtual void boost_preferred() override;
+    virtual void print_statistics() const override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
     virtual bool is_dead_end(
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
@@ -98,6 +100,12 @@ void AlternationOpenList<Entry>::boost_preferred() {
             priorities[i] -= boost_amount;
 }
 
+template<class Entry>
+void AlternationOpenList<Entry>::print_statistics() const {
+    for (const auto &sublist : open_lists)
+        sublist->print_statistics();
+}
+
 template<class Entry>
 void AlternationOpenList<Entry>::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
@@ -105,6 +113,12 @@ void AlternationOpenList<Entry>::get_path_dependent_evaluators(
         sublist->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void AlternationOpenList<Entry>::get_evaluators(set<Evaluator *> &evals) {
+    for (const auto &sublist : open_lists)
+        sublist->get_evaluators(evals);
+}
+
 template<class Entry>
 bool AlternationOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
@@ -0,0 +1,392 @@
+#include "bucket_astar_open_list.h"
+
+#include "../evaluator.h"
+#include "../open_list.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../algorithms/priority_queues.h"
+
+#include "../utils/memory.h"
+
+#include <cassert>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace bucket_astar_open_list {
+template<class Entry>
+class BucketAStarOpenList : public OpenList<Entry> {
+    static const int MIN_BUCKETS_BEFORE_SWITCH = 100;
+
+    using Stack = vector<Entry>;
+    using HAndEntry = pair<int, Entry>;
+
+    struct FBucket {
+        vector<Stack> h_stacks;
+        // Lower bound for the smallest h value with a non-empty stack.
+        int min_h;
+        int size;
+
+        FBucket()
+            : min_h(numeric_limits<int>::max()),
+              size(0) {
+        }
+    };
+
+    enum class Representation {
+        BUCKETS,
+        RADIX_HEAP,
+        MAP
+    };
+
+    Representation representation;
+
+    // Used for BUCKETS.
+    vector<FBucket> f_buckets;
+    // Lower bound for the smallest f value with a non-empty bucket.
+    int min_f;
+
+    /*
+      Used for RADIX_HEAP. The entries with f value current_f are kept in
+      current_h_stacks, the entries with larger f values in radix_heap.
+    */
+    unique_ptr<priority_queues::RadixHeapQueue<HAndEntry>> radix_heap;
+    map<int, Stack> current_h_stacks;
+    int current_f;
+
+    // Used for MAP.
+    map<pair<int, int>, Stack> sparse_buckets;
+
+    int size;
+    int num_pushes;
+
+    shared_ptr<Evaluator> f_evaluator;
+    shared_ptr<Evaluator> h_evaluator;
+
+    bool is_dense_key(int key) const;
+    static bool is_finite_key(int key);
+    void switch_to_radix_heap(int f);
+    void switch_to_map();
+    void insert_into_radix_heap(int f, int h, const Entry &entry);
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit BucketAStarOpenList(const Options &opts);
+    virtual ~BucketAStarOpenList() override = default;
+
+    virtual Entry remove_min() override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
+    virtual bool is_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+};
+
+
+template<class Entry>
+BucketAStarOpenList<Entry>::BucketAStarOpenList(const Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      representation(Representation::BUCKETS),
+      min_f(0),
+      current_f(0),
+      size(0),
+      num_pushes(0),
+      f_evaluator(opts.get<shared_ptr<Evaluator>>("f")),
+      h_evaluator(opts.get<shared_ptr<Evaluator>>("h")) {
+}
+
+template<class Entry>
+bool BucketAStarOpenList<Entry>::is_dense_key(int key) const {
+    // As in BucketQueue, we allow more buckets than pushes only for small keys.
+    return is_finite_key(key) &&
+           (key < MIN_BUCKETS_BEFORE_SWITCH || key <= num_pushes);
+}
+
+template<class Entry>
+bool BucketAStarOpenList<Entry>::is_finite_key(int key) {
+    return key >= 0 && key != numeric_limits<int>::max();
+}
+
+template<class Entry>
+void BucketAStarOpenList<Entry>::switch_to_radix_heap(int f) {
+    assert(representation == Representation::BUCKETS);
+    assert(is_finite_key(f));
+    current_f = f;
+    int num_buckets = f_buckets.size();
+    for (int bucket_f = min_f; bucket_f < num_buckets; ++bucket_f) {
+        if (f_buckets[bucket_f].size != 0) {
+            current_f = min(current_f, bucket_f);
+            break;
+        }
+    }
+    radix_heap = utils::make_unique_ptr<
+        priority_queues::RadixHeapQueue<HAndEntry>>(current_f);
+    for (int bucket_f = min_f; bucket_f < num_buckets; ++bucket_f) {
+        FBucket &bucket = f_buckets[bucket_f];
+        if (bucket.size == 0) {
+            continue;
+        }
+        for (int h = bucket.min_h; h < static_cast<int>(bucket.h_stacks.size()); ++h) {
+            for (const Entry &entry : bucket.h_stacks[h]) {
+                insert_into_radix_heap(bucket_f, h, entry);
+            }
+        }
+    }
+    vector<FBucket>().swap(f_buckets);
+    min_f = 0;
+    representation = Representation::RADIX_HEAP;
+}
+
+template<class Entry>
+void BucketAStarOpenList<Entry>::switch_to_map() {
+    if (representation == Representation::BUCKETS) {
+        for (int f = min_f; f < static_cast<int>(f_buckets.size()); ++f) {
+            FBucket &bucket = f_buckets[f];
+            if (bucket.size == 0) {
+                continue;
+            }
+            for (int h = bucket.min_h; h < static_cast<int>(bucket.h_stacks.size()); ++h) {
+                Stack &stack = bucket.h_stacks[h];
+                if (!stack.empty()) {
+                    sparse_buckets[make_pair(f, h)].swap(stack);
+                }
+            }
+        }
+        vector<FBucket>().swap(f_buckets);
+        min_f = 0;
+    } else {
+        assert(representation == Representation::RADIX_HEAP);
+        for (auto &h_and_stack : current_h_stacks) {
+            sparse_buckets[make_pair(current_f, h_and_stack.first)].swap(
+                h_and_stack.second);
+        }
+        current_h_stacks.clear();
+        while (!radix_heap->empty()) {
+            pair<int, HAndEntry> f_and_entry = radix_heap->pop();
+            sparse_buckets[make_pair(f_and_entry.first, f_and_entry.second.first)]
+            .push_back(f_and_entry.second.second);
+        }
+        radix_heap = nullptr;
+        current_f = 0;
+    }
+    representation = Representation::MAP;
+}
+
+template<class Entry>
+void BucketAStarOpenList<Entry>::insert_into_radix_heap(
+    int f, int h, const Entry &entry) {
+    assert(f >= current_f);
+    if (f == current_f) {
+        current_h_stacks[h].push_back(entry);
+    } else {
+        radix_heap->push(f, make_pair(h, entry));
+    }
+}
+
+template<class Entry>
+void BucketAStarOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    int f = eval_context.get_evaluator_value_or_infinity(f_evaluator.get());
+    int h = eval_context.get_evaluator_value_or_infinity(h_evaluator.get());
+    ++num_pushes;
+    if (representation == Representation::BUCKETS &&
+        (!is_dense_key(f) || !is_dense_key(h))) {
+        /*
+          Like BucketQueue, we switch to a radix heap for the f values as
+          long as they are monotone. Within an f value, the h values
+          decrease, so we order them with a map.
+        */
+        if (is_finite_key(f)) {
+            switch_to_radix_heap(f);
+        } else {
+            switch_to_map();
+        }
+    }
+    if (representation == Representation::RADIX_HEAP &&
+        (!is_finite_key(f) || f < current_f)) {
+        switch_to_map();
+    }
+
+    if (representation == Representation::BUCKETS) {
+        if (f >= static_cast<int>(f_buckets.size())) {
+            f_buckets.resize(f + 1);
+        }
+        min_f = min(min_f, f);
+        FBucket &bucket = f_buckets[f];
+        if (h >= static_cast<int>(bucket.h_stacks.size())) {
+            bucket.h_stacks.resize(h + 1);
+        }
+        bucket.min_h = min(bucket.min_h, h);
+        bucket.h_stacks[h].push_back(entry);
+        ++bucket.size;
+    } else if (representation == Representation::RADIX_HEAP) {
+        insert_into_radix_heap(f, h, entry);
+    } else {
+        sparse_buckets[make_pair(f, h)].push_back(entry);
+    }
+    ++size;
+}
+
+template<class Entry>
+Entry BucketAStarOpenList<Entry>::remove_min() {
+    assert(size > 0);
+    --size;
+    if (representation == Representation::MAP) {
+        auto it = sparse_buckets.begin();
+        assert(it != sparse_buckets.end());
+        Stack &stack = it->second;
+        assert(!stack.empty());
+        Entry result = stack.back();
+        stack.pop_back();
+        if (stack.empty()) {
+            sparse_buckets.erase(it);
+        }
+        return result;
+    } else if (representation == Representation::RADIX_HEAP) {
+        if (current_h_stacks.empty()) {
+            current_f = radix_heap->get_min_key();
+            while (!radix_heap->empty() &&
+                   radix_heap->get_min_key() == current_f) {
+                HAndEntry h_and_entry = radix_heap->pop().second;
+                current_h_stacks[h_and_entry.first].push_back(
+                    h_and_entry.second);
+            }
+        }
+        auto it = current_h_stacks.begin();
+        Stack &stack = it->second;
+        assert(!stack.empty());
+        Entry result = stack.back();
+        stack.pop_back();
+        if (stack.empty()) {
+            current_h_stacks.erase(it);
+        }
+        return result;
+    }
+
+    while (f_buckets[min_f].size == 0) {
+        ++min_f;
+        assert(min_f < static_cast<int>(f_buckets.size()));
+    }
+    FBucket &bucket = f_buckets[min_f];
+    while (bucket.h_stacks[bucket.min_h].empty()) {
+        ++bucket.min_h;
+        assert(bucket.min_h < static_cast<int>(bucket.h_stacks.size()));
+    }
+    Stack &stack = bucket.h_stacks[bucket.min_h];
+    Entry result = stack.back();
+    stack.pop_back();
+    if (--bucket.size == 0) {
+        // Release the stacks of the bucket since A* rarely comes back to it.
+        vector<Stack>().swap(bucket.h_stacks);
+        bucket.min_h = numeric_limits<int>::max();
+    }
+    return result;
+}
+
+template<class Entry>
+bool BucketAStarOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void BucketAStarOpenList<Entry>::clear() {
+    representation = Representation::BUCKETS;
+    f_buckets.clear();
+    min_f = 0;
+    radix_heap = nullptr;
+    current_h_stacks.clear();
+    current_f = 0;
+    sparse_buckets.clear();
+    size = 0;
+    num_pushes = 0;
+}
+
+template<class Entry>
+void BucketAStarOpenList<Entry>::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    f_evaluator->get_path_dependent_evaluators(evals);
+    h_evaluator->get_path_dependent_evaluators(evals);
+}
+
+template<class Entry>
+void BucketAStarOpenList<Entry>::get_evaluators(set<Evaluator *> &evals) {
+    evals.insert(f_evaluator.get());
+    evals.insert(h_evaluator.get());
+}
+
+template<class Entry>
+bool BucketAStarOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    // As tiebreaking([f, h], unsafe_pruning=false).
+    if (is_reliable_dead_end(eval_context))
+        return true;
+    return eval_context.is_evaluator_value_infinite(f_evaluator.get()) &&
+           eval_context.is_evaluator_value_infinite(h_evaluator.get());
+}
+
+template<class Entry>
+bool BucketAStarOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    for (Evaluator *evaluator : {f_evaluator.get(), h_evaluator.get()}) {
+        if (eval_context.is_evaluator_value_infinite(evaluator) &&
+            evaluator->dead_ends_are_reliable())
+            return true;
+    }
+    return false;
+}
+
+BucketAStarOpenListFactory::BucketAStarOpenListFactory(const Options &options)
+    : options(options) {
+}
+
+unique_ptr<StateOpenList>
+BucketAStarOpenListFactory::create_state_open_list() {
+    return utils::make_unique_ptr<BucketAStarOpenList<StateOpenListEntry>>(options);
+}
+
+unique_ptr<EdgeOpenList>
+BucketAStarOpenListFactory::create_edge_open_list() {
+    return utils::make_unique_ptr<BucketAStarOpenList<EdgeOpenListEntry>>(options);
+}
+
+static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Bucket-based A* open list",
+        "Selects an entry with minimal f value and among these one with "
+        "minimal h value, like tiebreaking([f, h], unsafe_pruning=false). "
+        "Entries with equal f and h values are selected in LIFO order. "
+        "The entries are kept in an array of f buckets, each of which is "
+        "an array of stacks indexed by h, so inserting and removing an "
+        "entry takes (amortized) constant time. If the values are much "
+        "larger than the number of insertions, the list switches to a "
+        "radix heap for the f values, which takes logarithmic time in the "
+        "largest f value, and keeps the entries of the smallest f value "
+        "in a map indexed by h. Only if an f value is negative or infinite "
+        "or smaller than the last removed f value, which requires an "
+        "inconsistent heuristic, the list switches to an ordered map of "
+        "(f, h) pairs. This is the open list used by astar().");
+    parser.add_option<shared_ptr<Evaluator>>("f", "evaluator for f values");
+    parser.add_option<shared_ptr<Evaluator>>(
+        "h", "evaluator for h values, used for breaking ties");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<BucketAStarOpenListFactory>(opts);
+}
+
+static Plugin<OpenListFactory> _plugin("bucket_astar", _parse);
+}
@@ -0,0 +1,34 @@
+#ifndef OPEN_LISTS_BUCKET_ASTAR_OPEN_LIST_H
+#define OPEN_LISTS_BUCKET_ASTAR_OPEN_LIST_H
+
+#include "../open_list_factory.h"
+#include "../option_parser_util.h"
+
+/*
+  Open list for A* that orders entries by f and breaks ties by h like
+  tiebreaking([f, h]), but stores them in two levels of buckets: an
+  array indexed by f whose elements are arrays of LIFO stacks indexed
+  by h. Insertions take constant time and removals amortized constant
+  time if the minimal f value rarely decreases, as in A* with a
+  consistent heuristic.
+
+  Like AdaptiveQueue (see priority_queues.h), the list switches to a
+  RadixHeapQueue for the f values when the number of buckets would
+  exceed the number of insertions. The entries of the smallest f value
+  are then kept in a map indexed by h, since h decreases within an f
+  value. If an f value is negative or infinite, or smaller than the
+  last removed one, we fall back to an ordered map of (f, h) pairs.
+*/
+namespace bucket_astar_open_list {
+class BucketAStarOpenListFactory : public OpenListFactory {
+    Options options;
+public:
+    explicit BucketAStarOpenListFactory(const Options &options);
+    virtual ~BucketAStarOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+}
+
+#endif
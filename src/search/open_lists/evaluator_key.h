@@ -0,0 +1,101 @@
+#ifndef OPEN_LISTS_EVALUATOR_KEY_H
+#define OPEN_LISTS_EVALUATOR_KEY_H
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list.h"
+
+#include "../utils/memory.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace options {
+class Options;
+}
+
+/*
+  Keys that hold the values of a list of evaluators for the buckets of
+  open lists. Open lists with up to three evaluators use keys of fixed
+  size, so computing a key needs no heap allocation:
+
+    1 evaluator:   int
+    2 evaluators:  std::uint64_t with both values, compared like the pair
+    3 evaluators:  std::array<int, 3>
+    more:          std::vector<int>
+
+  All key types compare lexicographically by the evaluator values.
+  compute_key() overwrites the given key, so open lists can reuse one
+  vector<int> for all insertions.
+*/
+namespace evaluator_key {
+using Evaluators = std::vector<std::shared_ptr<Evaluator>>;
+
+inline int get_value(
+    EvaluationContext &eval_context, const Evaluators &evaluators, int i) {
+    return eval_context.get_evaluator_value_or_infinity(evaluators[i].get());
+}
+
+inline void compute_key(
+    EvaluationContext &eval_context, const Evaluators &evaluators, int &key) {
+    assert(evaluators.size() == 1);
+    key = get_value(eval_context, evaluators, 0);
+}
+
+inline void compute_key(
+    EvaluationContext &eval_context, const Evaluators &evaluators,
+    std::uint64_t &key) {
+    assert(evaluators.size() == 2);
+    // Flipping the sign bit maps the order of int to that of uint32_t.
+    const std::uint32_t sign_bit = std::uint32_t(1) << 31;
+    std::uint32_t high = static_cast<std::uint32_t>(
+        get_value(eval_context, evaluators, 0)) ^ sign_bit;
+    std::uint32_t low = static_cast<std::uint32_t>(
+        get_value(eval_context, evaluators, 1)) ^ sign_bit;
+    key = (static_cast<std::uint64_t>(high) << 32) | low;
+}
+
+template<std::size_t N>
+void compute_key(
+    EvaluationContext &eval_context, const Evaluators &evaluators,
+    std::array<int, N> &key) {
+    assert(evaluators.size() == N);
+    for (std::size_t i = 0; i < N; ++i) {
+        key[i] = get_value(eval_context, evaluators, i);
+    }
+}
+
+inline void compute_key(
+    EvaluationContext &eval_context, const Evaluators &evaluators,
+    std::vector<int> &key) {
+    key.clear();
+    for (std::size_t i = 0; i < evaluators.size(); ++i) {
+        key.push_back(get_value(eval_context, evaluators, i));
+    }
+}
+
+/*
+  Create an OpenListType<Entry, Key> object with the smallest key type
+  for the given number of evaluators. The constructor is called with
+  opts.
+*/
+template<template<class, class> class OpenListType, class Entry>
+std::unique_ptr<OpenList<Entry>> create_open_list(
+    const options::Options &opts, std::size_t num_evaluators) {
+    switch (num_evaluators) {
+    case 1:
+        return utils::make_unique_ptr<OpenListType<Entry, int>>(opts);
+    case 2:
+        return utils::make_unique_ptr<OpenListType<Entry, std::uint64_t>>(opts);
+    case 3:
+        return utils::make_unique_ptr<OpenListType<Entry, std::array<int, 3>>>(opts);
+    default:
+        return utils::make_unique_ptr<OpenListType<Entry, std::vector<int>>>(opts);
+    }
+}
+}
+
+#endif
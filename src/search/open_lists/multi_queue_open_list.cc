@@ -0,0 +1,86 @@
+#include "multi_queue_open_list.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+namespace multi_queue_open_list {
+static int get_num_queues(const Options &options) {
+    int num_threads = options.get<int>("num_threads");
+    if (num_threads == 0) {
+        num_threads = max(1U, thread::hardware_concurrency());
+    }
+    return options.get<int>("queues_per_thread") * num_threads;
+}
+
+MultiQueueOpenListFactory::MultiQueueOpenListFactory(const Options &options)
+    : options(options) {
+}
+
+unique_ptr<StateOpenList>
+MultiQueueOpenListFactory::create_state_open_list() {
+    return utils::make_unique_ptr<MultiQueueOpenList<StateOpenListEntry>>(
+        options.get<shared_ptr<Evaluator>>("eval"), get_num_queues(options),
+        options.get<bool>("pref_only"));
+}
+
+unique_ptr<EdgeOpenList>
+MultiQueueOpenListFactory::create_edge_open_list() {
+    return utils::make_unique_ptr<MultiQueueOpenList<EdgeOpenListEntry>>(
+        options.get<shared_ptr<Evaluator>>("eval"), get_num_queues(options),
+        options.get<bool>("pref_only"));
+}
+
+static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "MultiQueue open list",
+        "Relaxed best-first open list for parallel search (Rihani, Sanders "
+        "and Dementiev, 2015). Entries are distributed randomly over "
+        "queues_per_thread * num_threads binary heaps with a lock each. "
+        "Removing an entry takes the best entry of the better of two "
+        "random heaps, so several threads can use the open list at the "
+        "same time with little contention, but the removed entry is not "
+        "always one with minimal evaluator value. Ties are broken "
+        "arbitrarily. The rank error is printed with the search "
+        "statistics: for each removed entry, we count the heaps whose best "
+        "entry was better, which is a lower bound for the number of better "
+        "entries in the open list.");
+    parser.document_note(
+        "Thread safety",
+        "Search engines that access the open list from several threads must "
+        "evaluate the states before inserting them, since evaluators are "
+        "not thread-safe. With sequential search engines, this open list "
+        "behaves like a randomized version of single() and is mainly useful "
+        "to measure the effect of the relaxed order.");
+    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator");
+    parser.add_option<int>(
+        "queues_per_thread",
+        "number of heaps per thread (the factor c of the MultiQueue). "
+        "More heaps reduce contention but increase the rank error.",
+        "2",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads that use the open list. If 0, use the number "
+        "of concurrent threads supported by the hardware.",
+        "1",
+        Bounds("0", "infinity"));
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<MultiQueueOpenListFactory>(opts);
+}
+
+static Plugin<OpenListFactory> _plugin("multi_queue", _parse);
+}
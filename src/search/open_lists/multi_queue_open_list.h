@@ -0,0 +1,120 @@
+#ifndef OPEN_LISTS_MULTI_QUEUE_OPEN_LIST_H
+#define OPEN_LISTS_MULTI_QUEUE_OPEN_LIST_H
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list.h"
+#include "../open_list_factory.h"
+#include "../option_parser_util.h"
+
+#include "../algorithms/multi_queue.h"
+
+#include <cassert>
+#include <memory>
+#include <set>
+
+/*
+  Open list that orders entries by a single evaluator like
+  BestFirstOpenList, but stores them in a MultiQueue (see
+  algorithms/multi_queue.h), so that several threads can insert and
+  remove entries without a global lock. In exchange, remove_min() only
+  returns an entry with a small value, not necessarily the minimal one.
+
+  All methods except clear() may be called concurrently, under the
+  following conditions:
+
+  - insert() must be called with evaluation contexts that already
+    contain the value of the evaluator and, if pref_only is set, the
+    preferredness of the entry. Evaluators are not thread-safe, so the
+    open list must not evaluate the state itself.
+  - Since another thread may remove the last entry between empty() and
+    remove_min(), threads should call try_remove_min() instead.
+
+  Concurrent uses need the class itself, so it is defined here rather
+  than in the .cc file like the other open lists.
+*/
+namespace multi_queue_open_list {
+template<class Entry>
+class MultiQueueOpenList : public OpenList<Entry> {
+    std::shared_ptr<Evaluator> evaluator;
+    multi_queue::MultiQueue<Entry> queue;
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override {
+        queue.push(eval_context.get_evaluator_value(evaluator.get()), entry);
+    }
+
+public:
+    MultiQueueOpenList(
+        const std::shared_ptr<Evaluator> &evaluator, int num_queues,
+        bool preferred_only)
+        : OpenList<Entry>(preferred_only),
+          evaluator(evaluator),
+          queue(num_queues) {
+    }
+    virtual ~MultiQueueOpenList() override = default;
+
+    // Return an entry with a small value or nullopt if the list is empty.
+    tl::optional<Entry> try_remove_min() {
+        tl::optional<std::pair<int, Entry>> result = queue.try_pop();
+        if (!result) {
+            return tl::nullopt;
+        }
+        return result->second;
+    }
+
+    virtual Entry remove_min() override {
+        while (true) {
+            assert(!empty());
+            tl::optional<Entry> result = try_remove_min();
+            if (result) {
+                return *result;
+            }
+        }
+    }
+
+    virtual bool empty() const override {
+        return queue.empty();
+    }
+
+    virtual void clear() override {
+        queue.clear();
+    }
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override {
+        evaluator->get_path_dependent_evaluators(evals);
+    }
+
+    virtual void get_evaluators(std::set<Evaluator *> &evals) override {
+        evals.insert(evaluator.get());
+    }
+
+    virtual bool is_dead_end(EvaluationContext &eval_context) const override {
+        return eval_context.is_evaluator_value_infinite(evaluator.get());
+    }
+
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override {
+        return is_dead_end(eval_context) && evaluator->dead_ends_are_reliable();
+    }
+
+    virtual void print_statistics() const override {
+        queue.print_statistics();
+    }
+};
+
+
+class MultiQueueOpenListFactory : public OpenListFactory {
+    Options options;
+public:
+    explicit MultiQueueOpenListFactory(const Options &options);
+    virtual ~MultiQueueOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+}
+
+#endif
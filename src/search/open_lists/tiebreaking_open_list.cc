@@ -1,5 +1,7 @@
 #include "tiebreaking_open_list.h"
 
+#include "evaluator_key.h"
+
 #include "../evaluator.h"
 #include "../open_list.h"
 #include "../option_parser.h"
@@ -7,21 +9,66 @@
 
 #include "../utils/memory.h"
 
+#include <algorithm>
 #include <cassert>
-#include <deque>
-#include <map>
 #include <utility>
 #include <vector>
 
 using namespace std;
 
 namespace tiebreaking_open_list {
+/*
+  FIFO queue of the entries with the same key. Removed entries stay in the
+  vector until they make up half of it, so removing entries takes amortized
+  constant time. Unlike a deque, the bucket can be moved without allocating.
+*/
 template<class Entry>
+class Bucket {
+    vector<Entry> entries;
+    size_t first;
+public:
+    Bucket()
+        : first(0) {
+    }
+
+    void push_back(const Entry &entry) {
+        entries.push_back(entry);
+    }
+
+    Entry pop_front() {
+        assert(!empty());
+        Entry result = entries[first];
+        ++first;
+        if (2 * first >= entries.size()) {
+            entries.erase(entries.begin(), entries.begin() + first);
+            first = 0;
+        }
+        return result;
+    }
+
+    bool empty() const {
+        return first == entries.size();
+    }
+};
+
+/*
+  Key is one of the key types in evaluator_key.h. The buckets are ordered
+  lexicographically by the evaluator values.
+*/
+template<class Entry, class Key>
 class TieBreakingOpenList : public OpenList<Entry> {
-    using Bucket = deque<Entry>;
+    using KeyAndBucket = pair<Key, Bucket<Entry>>;
 
-    map<const vector<int>, Bucket> buckets;
+    /*
+      Non-empty buckets sorted by decreasing key in a flat vector, so that
+      the bucket with the minimal key is at the back. There are usually few
+      distinct keys, and searches mostly insert entries with keys close to
+      the minimum, so adding a bucket rarely moves many others.
+    */
+    vector<KeyAndBucket> buckets;
     int size;
+    // Reused for all insertions to avoid allocating vector<int> keys.
+    Key key;
 
     vector<shared_ptr<Evaluator>> evaluators;
     /*
@@ -45,6 +92,7 @@ public:
     virtual bool empty() const override;
     virtual void clear() override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
     virtual bool is_dead_end(
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
@@ -52,65 +100,72 @@ public:
 };
 
 
-template<class Entry>
-TieBreakingOpenList<Entry>::TieBreakingOpenList(const Options &opts)
+template<class Entry, class Key>
+TieBreakingOpenList<Entry, Key>::TieBreakingOpenList(const Options &opts)
     : OpenList<Entry>(opts.get<bool>("pref_only")),
-      size(0), evaluators(opts.get_list<shared_ptr<Evaluator>>("evals")),
+      size(0), key(), evaluators(opts.get_list<shared_ptr<Evaluator>>("evals")),
       allow_unsafe_pruning(opts.get<bool>("unsafe_pruning")) {
 }
 
-template<class Entry>
-void TieBreakingOpenList<Entry>::do_insertion(
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
-    vector<int> key;
-    key.reserve(evaluators.size());
-    for (const shared_ptr<Evaluator> &evaluator : evaluators)
-        key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get()));
-
-    buckets[key].push_back(entry);
+    evaluator_key::compute_key(eval_context, evaluators, key);
+    // Find the first bucket whose key is not greater than key.
+    auto it = lower_bound(
+        buckets.begin(), buckets.end(), key,
+        [](const KeyAndBucket &bucket, const Key &new_key) {return new_key < bucket.first;});
+    if (it == buckets.end() || it->first != key) {
+        it = buckets.emplace(it, key, Bucket<Entry>());
+    }
+    it->second.push_back(entry);
     ++size;
 }
 
-template<class Entry>
-Entry TieBreakingOpenList<Entry>::remove_min() {
+template<class Entry, class Key>
+Entry TieBreakingOpenList<Entry, Key>::remove_min() {
     assert(size > 0);
-    typename map<const vector<int>, Bucket>::iterator it;
-    it = buckets.begin();
-    assert(it != buckets.end());
-    assert(!it->second.empty());
+    assert(!buckets.empty());
+    Bucket<Entry> &bucket = buckets.back().second;
+    assert(!bucket.empty());
     --size;
-    Entry result = it->second.front();
-    it->second.pop_front();
-    if (it->second.empty())
-        buckets.erase(it);
+    Entry result = bucket.pop_front();
+    if (bucket.empty())
+        buckets.pop_back();
     return result;
 }
 
-template<class Entry>
-bool TieBreakingOpenList<Entry>::empty() const {
+template<class Entry, class Key>
+bool TieBreakingOpenList<Entry, Key>::empty() const {
     return size == 0;
 }
 
-template<class Entry>
-void TieBreakingOpenList<Entry>::clear() {
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::clear() {
     buckets.clear();
     size = 0;
 }
 
-template<class Entry>
-int TieBreakingOpenList<Entry>::dimension() const {
+template<class Entry, class Key>
+int TieBreakingOpenList<Entry, Key>::dimension() const {
     return evaluators.size();
 }
 
-template<class Entry>
-void TieBreakingOpenList<Entry>::get_path_dependent_evaluators(
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         evaluator->get_path_dependent_evaluators(evals);
 }
 
-template<class Entry>
-bool TieBreakingOpenList<Entry>::is_dead_end(
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::get_evaluators(set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evals.insert(evaluator.get());
+}
+
+template<class Entry, class Key>
+bool TieBreakingOpenList<Entry, Key>::is_dead_end(
     EvaluationContext &eval_context) const {
     // TODO: Properly document this behaviour.
     // If one safe heuristic detects a dead end, return true.
@@ -128,8 +183,8 @@ bool TieBreakingOpenList<Entry>::is_dead_end(
     return true;
 }
 
-template<class Entry>
-bool TieBreakingOpenList<Entry>::is_reliable_dead_end(
+template<class Entry, class Key>
+bool TieBreakingOpenList<Entry, Key>::is_reliable_dead_end(
     EvaluationContext &eval_context) const {
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         if (eval_context.is_evaluator_value_infinite(evaluator.get()) &&
@@ -144,12 +199,14 @@ TieBreakingOpenListFactory::TieBreakingOpenListFactory(const Options &options)
 
 unique_ptr<StateOpenList>
 TieBreakingOpenListFactory::create_state_open_list() {
-    return utils::make_unique_ptr<TieBreakingOpenList<StateOpenListEntry>>(options);
+    return evaluator_key::create_open_list<TieBreakingOpenList, StateOpenListEntry>(
+        options, options.get_list<shared_ptr<Evaluator>>("evals").size());
 }
 
 unique_ptr<EdgeOpenList>
 TieBreakingOpenListFactory::create_edge_open_list() {
-    return utils::make_unique_ptr<TieBreakingOpenList<EdgeOpenListEntry>>(options);
+    return evaluator_key::create_open_list<TieBreakingOpenList, EdgeOpenListEntry>(
+        options, options.get_list<shared_ptr<Evaluator>>("evals").size());
 }
 
 static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
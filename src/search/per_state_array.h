@@ -4,6 +4,7 @@
 #include "per_state_information.h"
 
 #include <cassert>
+#include <memory>
 #include <unordered_map>
 
 class GlobalState;
@@ -34,6 +35,26 @@ public:
     }
 };
 
+template<class T>
+class ConstArrayView {
+    const T *p;
+    int size_;
+public:
+    ConstArrayView(const T *p, int size) : p(p), size_(size) {}
+    ConstArrayView(const ConstArrayView<T> &other) = default;
+
+    ConstArrayView<T> &operator=(const ConstArrayView<T> &other) = default;
+
+    const T &operator[](int index) const {
+        assert(index >= 0 && index < size_);
+        return p[index];
+    }
+
+    int size() const {
+        return size_;
+    }
+};
+
 /*
   PerStateArray is used to associate array-like information with states.
   PerStateArray<Entry> logically behaves somewhat like an unordered map
@@ -42,26 +63,31 @@ public:
   (similar to the defaultdict class in Python).
 
   The implementation is similar to the one of PerStateInformation, which
-  also contains more documentation.
+  also contains more documentation. Like PerStateInformation, it can store
+  its entries in the memory-mapped file of a MappedFileArena.
 */
 
 template<class Element>
-class PerStateArray : public subscriber::Subscriber<StateRegistry> {
+class PerStateArray : public subscriber::Subscriber<StateRegistryBase> {
+    using EntryArrayVector = segmented_vector::SegmentedArrayVector<
+        Element, mapped_file_arena::ArenaAllocator<Element>>;
     const std::vector<Element> default_array;
-    using EntryArrayVectorMap = std::unordered_map<const StateRegistry *,
-                                                   segmented_vector::SegmentedArrayVector<Element> *>;
+    const std::shared_ptr<mapped_file_arena::MappedFileArena> arena;
+    using EntryArrayVectorMap = std::unordered_map<const StateRegistryBase *,
+                                                   EntryArrayVector *>;
     EntryArrayVectorMap entry_arrays_by_registry;
 
-    mutable const StateRegistry *cached_registry;
-    mutable segmented_vector::SegmentedArrayVector<Element> *cached_entries;
+    mutable const StateRegistryBase *cached_registry;
+    mutable EntryArrayVector *cached_entries;
 
-    segmented_vector::SegmentedArrayVector<Element> *get_entries(const StateRegistry *registry) {
+    EntryArrayVector *get_entries(const StateRegistryBase *registry) {
         if (cached_registry != registry) {
             cached_registry = registry;
             auto it = entry_arrays_by_registry.find(registry);
             if (it == entry_arrays_by_registry.end()) {
-                cached_entries = new segmented_vector::SegmentedArrayVector<Element>(
-                    default_array.size());
+                cached_entries = new EntryArrayVector(
+                    default_array.size(),
+                    mapped_file_arena::ArenaAllocator<Element>(arena));
                 entry_arrays_by_registry[registry] = cached_entries;
                 registry->subscribe(this);
             } else {
@@ -72,16 +98,15 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
         return cached_entries;
     }
 
-    const segmented_vector::SegmentedArrayVector<Element> *get_entries(
-        const StateRegistry *registry) const {
+    const EntryArrayVector *get_entries(
+        const StateRegistryBase *registry) const {
         if (cached_registry != registry) {
             const auto it = entry_arrays_by_registry.find(registry);
             if (it == entry_arrays_by_registry.end()) {
                 return nullptr;
             } else {
                 cached_registry = registry;
-                cached_entries = const_cast<segmented_vector::SegmentedArrayVector<Element> *>(
-                    it->second);
+                cached_entries = const_cast<EntryArrayVector *>(it->second);
             }
         }
         assert(cached_registry == registry);
@@ -89,8 +114,11 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
     }
 
 public:
-    explicit PerStateArray(const std::vector<Element> &default_array)
+    explicit PerStateArray(
+        const std::vector<Element> &default_array,
+        const std::shared_ptr<mapped_file_arena::MappedFileArena> &arena = nullptr)
         : default_array(default_array),
+          arena(arena),
           cached_registry(nullptr),
           cached_entries(nullptr) {
     }
@@ -105,9 +133,9 @@ public:
     }
 
     ArrayView<Element> operator[](const GlobalState &state) {
-        const StateRegistry *registry = &state.get_registry();
-        segmented_vector::SegmentedArrayVector<Element> *entries = get_entries(registry);
-        int state_id = state.get_id().value;
+        const StateRegistryBase *registry = &state.get_registry();
+        EntryArrayVector *entries = get_entries(registry);
+        StateID::value_type state_id = state.get_id().value;
         size_t virtual_size = registry->size();
         assert(utils::in_bounds(state_id, *registry));
         if (entries->size() < virtual_size) {
@@ -116,19 +144,27 @@ public:
         return ArrayView<Element>((*entries)[state_id], default_array.size());
     }
 
-    ArrayView<Element> operator[](const GlobalState &) const {
-        ABORT("PerStateArray::operator[] const not implemented. "
-              "See source code for more information.");
-        /*
-          This method is not implemented because it is currently not used and
-          would require quite a bit of boilerplate, introducing a ConstArrayView
-          class similar to ArrayView. If you need it, it should be easy to
-          implement based on PerStateInformation:operator[] const. This method
-          should return a ConstArrayView<Element>.
-        */
+    ConstArrayView<Element> operator[](const GlobalState &state) const {
+        return get(state.get_registry(), state.get_id());
+    }
+
+    /*
+      Look up the entry of a state by its ID. Unlike operator[], this does
+      not need the data of the state, which some registries only keep for
+      a while (see BitstateStateRegistry).
+    */
+    ConstArrayView<Element> get(const StateRegistryBase &registry, StateID id) const {
+        const EntryArrayVector *entries = get_entries(&registry);
+        StateID::value_type state_id = id.value;
+        assert(utils::in_bounds(state_id, registry));
+        if (!entries || static_cast<size_t>(state_id) >= entries->size()) {
+            return ConstArrayView<Element>(
+                default_array.data(), default_array.size());
+        }
+        return ConstArrayView<Element>((*entries)[state_id], default_array.size());
     }
 
-    virtual void notify_service_destroyed(const StateRegistry *registry) override {
+    virtual void notify_service_destroyed(const StateRegistryBase *registry) override {
         delete entry_arrays_by_registry[registry];
         entry_arrays_by_registry.erase(registry);
         if (registry == cached_registry) {
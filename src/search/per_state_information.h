@@ -5,11 +5,13 @@
 #include "state_id.h"
 #include "state_registry.h"
 
+#include "algorithms/mapped_file_arena.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
 #include "utils/collections.h"
 
 #include <cassert>
+#include <memory>
 #include <unordered_map>
 
 /*
@@ -36,16 +38,22 @@
   stores information. Once a StateRegistry is destroyed, it notifies all
   subscribed objects, which in turn destroy all information stored for states
   in that registry.
+
+  If a PerStateInformation object is given a MappedFileArena, the entries
+  are stored in the memory-mapped file of the arena instead of on the heap.
 */
 template<class Entry>
-class PerStateInformation : public subscriber::Subscriber<StateRegistry> {
+class PerStateInformation : public subscriber::Subscriber<StateRegistryBase> {
+    using EntryVector = segmented_vector::SegmentedVector<
+        Entry, mapped_file_arena::ArenaAllocator<Entry>>;
     const Entry default_value;
-    using EntryVectorMap = std::unordered_map<const StateRegistry *,
-                                              segmented_vector::SegmentedVector<Entry> * >;
+    const std::shared_ptr<mapped_file_arena::MappedFileArena> arena;
+    using EntryVectorMap = std::unordered_map<const StateRegistryBase *,
+                                              EntryVector * >;
     EntryVectorMap entries_by_registry;
 
-    mutable const StateRegistry *cached_registry;
-    mutable segmented_vector::SegmentedVector<Entry> *cached_entries;
+    mutable const StateRegistryBase *cached_registry;
+    mutable EntryVector *cached_entries;
 
     /*
       Returns the SegmentedVector associated with the given StateRegistry.
@@ -53,12 +61,13 @@ class PerStateInformation : public subscriber::Subscriber<StateRegistry> {
       Both the registry and the returned vector are cached to speed up
       consecutive calls with the same registry.
     */
-    segmented_vector::SegmentedVector<Entry> *get_entries(const StateRegistry *registry) {
+    EntryVector *get_entries(const StateRegistryBase *registry) {
         if (cached_registry != registry) {
             cached_registry = registry;
             auto it = entries_by_registry.find(registry);
             if (it == entries_by_registry.end()) {
-                cached_entries = new segmented_vector::SegmentedVector<Entry>();
+                cached_entries = new EntryVector(
+                    mapped_file_arena::ArenaAllocator<Entry>(arena));
                 entries_by_registry[registry] = cached_entries;
                 registry->subscribe(this);
             } else {
@@ -75,14 +84,14 @@ class PerStateInformation : public subscriber::Subscriber<StateRegistry> {
       Otherwise, both the registry and the returned vector are cached to speed
       up consecutive calls with the same registry.
     */
-    const segmented_vector::SegmentedVector<Entry> *get_entries(const StateRegistry *registry) const {
+    const EntryVector *get_entries(const StateRegistryBase *registry) const {
         if (cached_registry != registry) {
             const auto it = entries_by_registry.find(registry);
             if (it == entries_by_registry.end()) {
                 return nullptr;
             } else {
                 cached_registry = registry;
-                cached_entries = const_cast<segmented_vector::SegmentedVector<Entry> *>(it->second);
+                cached_entries = const_cast<EntryVector *>(it->second);
             }
         }
         assert(cached_registry == registry);
@@ -96,8 +105,11 @@ public:
           cached_entries(nullptr) {
     }
 
-    explicit PerStateInformation(const Entry &default_value_)
+    explicit PerStateInformation(
+        const Entry &default_value_,
+        const std::shared_ptr<mapped_file_arena::MappedFileArena> &arena_ = nullptr)
         : default_value(default_value_),
+          arena(arena_),
           cached_registry(nullptr),
           cached_entries(nullptr) {
     }
@@ -112,9 +124,9 @@ public:
     }
 
     Entry &operator[](const GlobalState &state) {
-        const StateRegistry *registry = &state.get_registry();
-        segmented_vector::SegmentedVector<Entry> *entries = get_entries(registry);
-        int state_id = state.get_id().value;
+        const StateRegistryBase *registry = &state.get_registry();
+        EntryVector *entries = get_entries(registry);
+        StateID::value_type state_id = state.get_id().value;
         size_t virtual_size = registry->size();
         assert(utils::in_bounds(state_id, *registry));
         if (entries->size() < virtual_size) {
@@ -124,21 +136,20 @@ public:
     }
 
     const Entry &operator[](const GlobalState &state) const {
-        const StateRegistry *registry = &state.get_registry();
-        const segmented_vector::SegmentedVector<Entry> *entries = get_entries(registry);
+        const StateRegistryBase *registry = &state.get_registry();
+        const EntryVector *entries = get_entries(registry);
         if (!entries) {
             return default_value;
         }
-        int state_id = state.get_id().value;
+        StateID::value_type state_id = state.get_id().value;
         assert(utils::in_bounds(state_id, *registry));
-        int num_entries = entries->size();
-        if (state_id >= num_entries) {
+        if (static_cast<size_t>(state_id) >= entries->size()) {
             return default_value;
         }
         return (*entries)[state_id];
     }
 
-    virtual void notify_service_destroyed(const StateRegistry *registry) override {
+    virtual void notify_service_destroyed(const StateRegistryBase *registry) override {
         delete entries_by_registry[registry];
         entries_by_registry.erase(registry);
         if (registry == cached_registry) {
@@ -1,5 +1,7 @@
 #include "search_engine.h"
 
+#include "bitstate_state_registry.h"
+#include "compressed_state_registry.h"
 #include "evaluation_context.h"
 #include "evaluator.h"
 #include "option_parser.h"
@@ -11,6 +13,7 @@
 #include "tasks/root_task.h"
 #include "utils/countdown_timer.h"
 #include "utils/logging.h"
+#include "utils/memory.h"
 #include "utils/rng_options.h"
 #include "utils/system.h"
 #include "utils/timer.h"
@@ -41,14 +44,52 @@ successor_generator::SuccessorGenerator &get_successor_generator(const TaskProxy
     return successor_generator;
 }
 
+static shared_ptr<mapped_file_arena::MappedFileArena> create_spill_arena(
+    const Options &opts) {
+    if (opts.contains("spill_directory")) {
+        return make_shared<mapped_file_arena::MappedFileArena>(
+            opts.get<string>("spill_directory"));
+    }
+    return nullptr;
+}
+
+static unique_ptr<StateRegistry> create_state_registry(
+    const TaskProxy &task_proxy, const Options &opts,
+    const shared_ptr<mapped_file_arena::MappedFileArena> &spill_arena) {
+    shared_ptr<mapped_file_arena::MappedFileArena> arena =
+        opts.get<bool>("spill_state_data") ? spill_arena : nullptr;
+    unique_ptr<StateRegistry> bitstate_registry =
+        create_bitstate_state_registry(task_proxy, opts, arena);
+    if (bitstate_registry) {
+        return bitstate_registry;
+    }
+    StateHashing state_hashing = opts.get<StateHashing>("state_hashing");
+    if (opts.get<StateCompression>("state_compression") == StateCompression::TREE) {
+        if (state_hashing != StateHashing::PACKED_DATA) {
+            cerr << "error: state_compression=tree does not support "
+                 << "state_hashing=zobrist" << endl;
+            utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+        }
+        return utils::make_unique_ptr<CompressedStateRegistry>(
+            task_proxy, arena);
+    }
+    return utils::make_unique_ptr<StateRegistry>(
+        task_proxy, state_hashing, arena);
+}
+
 SearchEngine::SearchEngine(const Options &opts)
     : status(IN_PROGRESS),
       solution_found(false),
       task(tasks::g_root_task),
       task_proxy(*task),
-      state_registry(task_proxy),
+      spill_arena(create_spill_arena(opts)),
+      state_registry_ptr(create_state_registry(task_proxy, opts, spill_arena)),
+      state_registry(*state_registry_ptr),
       successor_generator(get_successor_generator(task_proxy)),
-      search_space(state_registry),
+      search_space(
+          state_registry, opts.get<OperatorCost>("cost_type"),
+          opts.get<bool>("store_parents"),
+          opts.get<bool>("spill_search_nodes") ? spill_arena : nullptr),
       search_progress(opts.get<utils::Verbosity>("verbosity")),
       statistics(opts.get<utils::Verbosity>("verbosity")),
       cost_type(opts.get<OperatorCost>("cost_type")),
@@ -97,6 +138,9 @@ void SearchEngine::search() {
     }
     // TODO: Revise when and which search times are logged.
     utils::g_log << "Actual search time: " << timer.get_elapsed_time() << endl;
+    if (spill_arena) {
+        spill_arena->print_statistics();
+    }
 }
 
 bool SearchEngine::check_goal_and_set_plan(const GlobalState &state) {
@@ -149,6 +193,39 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    add_state_hashing_option_to_parser(parser);
+    add_state_compression_option_to_parser(parser);
+    parser.add_option<string>(
+        "spill_directory",
+        "directory for a temporary memory-mapped file that holds the "
+        "containers selected with spill_state_data and spill_search_nodes. "
+        "The operating system can then move their cold pages to this file "
+        "when physical memory runs out, which slows the search down instead "
+        "of ending it. Use a directory on a fast local disk. This does not "
+        "help against limits on the address space (ulimit -v), which count "
+        "the mapped file. If not given, everything is stored on the heap.",
+        OptionParser::NONE);
+    parser.add_option<bool>(
+        "spill_state_data",
+        "store the state data of the state registry in the spill file",
+        "true");
+    parser.add_option<bool>(
+        "spill_search_nodes",
+        "store the search node infos (g values, parents, status) in the "
+        "spill file",
+        "true");
+    parser.add_option<bool>(
+        "store_parents",
+        "store the parent state and creating operator of each search node. "
+        "Without them, search nodes need at least 4 instead of 9 bytes per "
+        "state, and the plan is reconstructed from the g values by regressing "
+        "the goal state and looking up the predecessors in the state "
+        "registry. For each plan step and operator, this looks up every "
+        "combination of values of the variables that the operator changes "
+        "without a precondition on them, i.e., up to the product of their "
+        "domain sizes. Tasks with conditional effects and operators with more "
+        "than 1024 such combinations are not supported.",
+        "true");
     utils::add_verbosity_option_to_parser(parser);
 }
 
@@ -10,6 +10,7 @@
 #include "state_registry.h"
 #include "task_proxy.h"
 
+#include <memory>
 #include <vector>
 
 namespace options {
@@ -43,7 +44,11 @@ protected:
     TaskProxy task_proxy;
 
     PlanManager plan_manager;
-    StateRegistry state_registry;
+    // Memory-mapped file for the containers that spill to disk (or nullptr).
+    std::shared_ptr<mapped_file_arena::MappedFileArena> spill_arena;
+    // The type of the registry depends on the options.
+    std::unique_ptr<StateRegistry> state_registry_ptr;
+    StateRegistry &state_registry;
     const successor_generator::SuccessorGenerator &successor_generator;
     SearchSpace search_space;
     SearchProgress search_progress;
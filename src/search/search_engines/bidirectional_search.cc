@@ -0,0 +1,541 @@
+#include "bidirectional_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <set>
+
+using namespace std;
+
+namespace bidirectional_search {
+static const int INF = numeric_limits<int>::max();
+
+const int PartialStateRegistry::UNDEFINED;
+const int PartialStateRegistry::SCRATCH_ID;
+
+static vector<int> get_partial_state_ranges(const TaskProxy &task_proxy) {
+    vector<int> ranges;
+    ranges.reserve(task_proxy.get_variables().size());
+    for (VariableProxy var : task_proxy.get_variables()) {
+        // Value 0 encodes UNDEFINED.
+        ranges.push_back(var.get_domain_size() + 1);
+    }
+    return ranges;
+}
+
+int_hash_set::HashType PartialStateRegistry::SemanticHash::operator()(int id) const {
+    return StateRegistry::hash_state_data(data[id], num_bins);
+}
+
+PartialStateRegistry::PartialStateRegistry(const TaskProxy &task_proxy)
+    : num_variables(task_proxy.get_variables().size()),
+      packer(get_partial_state_ranges(task_proxy)),
+      data_pool(packer.get_num_bins()),
+      scratch_buffer(packer.get_num_bins()),
+      registered_states(
+          SemanticHash(DataAccessor(data_pool, scratch_buffer.data()),
+                       packer.get_num_bins()),
+          SemanticEqual(DataAccessor(data_pool, scratch_buffer.data()),
+                        packer.get_num_bins())) {
+}
+
+void PartialStateRegistry::pack_into_scratch_buffer(const vector<int> &values) {
+    // Avoid garbage values in half-full bins.
+    fill(scratch_buffer.begin(), scratch_buffer.end(), 0);
+    for (int var = 0; var < num_variables; ++var) {
+        packer.set(scratch_buffer.data(), var, values[var] - UNDEFINED);
+    }
+}
+
+pair<int, bool> PartialStateRegistry::insert(const vector<int> &values) {
+    int id = find(values);
+    if (id != -1) {
+        return make_pair(id, false);
+    }
+    id = data_pool.size();
+    data_pool.push_back(scratch_buffer.data());
+    int_hash_set::HashType hash = StateRegistry::hash_state_data(
+        scratch_buffer.data(), scratch_buffer.size());
+    registered_states.insert(id, hash);
+    return make_pair(id, true);
+}
+
+int PartialStateRegistry::find(const vector<int> &values) {
+    pack_into_scratch_buffer(values);
+    int_hash_set::HashType hash = StateRegistry::hash_state_data(
+        scratch_buffer.data(), scratch_buffer.size());
+    return registered_states.find(SCRATCH_ID, hash);
+}
+
+void PartialStateRegistry::unpack(int id, vector<int> &values) const {
+    values.resize(num_variables);
+    packer.unpack_all(data_pool[id], values.data());
+    for (int &value : values) {
+        value += UNDEFINED;
+    }
+}
+
+
+BidirectionalSearch::BidirectionalSearch(const Options &opts)
+    : SearchEngine(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      forward_h(-1),
+      num_forward_expansions(0),
+      backward_registry(task_proxy),
+      num_backward_expansions(0),
+      operator_marks(task_proxy.get_operators().size(), 0),
+      use_partial_states(false),
+      best_plan_cost(INF),
+      best_forward_id(StateID::no_state),
+      best_backward_id(-1) {
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+
+    VariablesProxy variables = task_proxy.get_variables();
+    achievers.resize(variables.size());
+    for (VariableProxy var : variables) {
+        achievers[var.get_id()].resize(var.get_domain_size());
+    }
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        vector<bool> has_precondition(variables.size(), false);
+        for (FactProxy pre : op.get_preconditions()) {
+            has_precondition[pre.get_variable().get_id()] = true;
+        }
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            achievers[fact.var][fact.value].push_back(OperatorID(op.get_id()));
+            if (!has_precondition[fact.var]) {
+                use_partial_states = true;
+            }
+        }
+    }
+    if (task_proxy.get_goals().size() < variables.size()) {
+        use_partial_states = true;
+    }
+    if (use_partial_states) {
+        forward_states_by_fact.resize(variables.size());
+        backward_nodes_by_fact.resize(variables.size());
+        for (VariableProxy var : variables) {
+            forward_states_by_fact[var.get_id()].resize(var.get_domain_size());
+            backward_nodes_by_fact[var.get_id()].resize(var.get_domain_size());
+        }
+    }
+}
+
+void BidirectionalSearch::initialize() {
+    utils::g_log << "Conducting bidirectional search, (real) bound = " << bound
+                 << endl;
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "Bidirectional search does not support path-dependent "
+             << "evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    if (use_partial_states) {
+        utils::g_log << "Backward search uses partial states." << endl;
+    }
+
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    int h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+    if (h == EvaluationResult::INFTY) {
+        utils::g_log << "Initial state is a dead end." << endl;
+        return;
+    }
+    SearchNode node = search_space.get_node(initial_state);
+    node.open_initial();
+    forward_h[initial_state] = h;
+    register_forward_state(
+        initial_state.get_id(), initial_state.unpack().get_values());
+    forward_queue.push(get_forward_priority(initial_state.get_id()),
+                       initial_state.get_id());
+
+    vector<int> goal_values(
+        task_proxy.get_variables().size(), PartialStateRegistry::UNDEFINED);
+    for (FactProxy goal : task_proxy.get_goals()) {
+        FactPair fact = goal.get_pair();
+        goal_values[fact.var] = fact.value;
+    }
+    int goal_id = backward_registry.insert(goal_values).first;
+    backward_nodes.emplace_back(0, 0, -1, OperatorID::no_operator);
+    register_backward_node(goal_id, goal_values);
+    check_backward_meeting(goal_id, goal_values);
+    backward_queue.push(get_backward_priority(goal_id), goal_id);
+}
+
+void BidirectionalSearch::update_best_meeting(StateID forward_id, int backward_id) {
+    SearchNode node = search_space.get_node(state_registry.lookup_state(forward_id));
+    const BackwardNode &backward_node = backward_nodes[backward_id];
+    if (node.get_real_g() + backward_node.real_g >= bound) {
+        return;
+    }
+    int plan_cost = node.get_g() + backward_node.g;
+    if (plan_cost < best_plan_cost) {
+        best_plan_cost = plan_cost;
+        best_forward_id = forward_id;
+        best_backward_id = backward_id;
+        utils::g_log << "Directions met with plan cost " << plan_cost << " ["
+                     << statistics.get_expanded() << " expanded]" << endl;
+    }
+}
+
+void BidirectionalSearch::check_forward_meeting(
+    StateID id, const vector<int> &values) {
+    if (!use_partial_states) {
+        int backward_id = backward_registry.find(values);
+        if (backward_id != -1) {
+            update_best_meeting(id, backward_id);
+        }
+        return;
+    }
+    vector<int> partial_values;
+    for (size_t var = 0; var < values.size(); ++var) {
+        for (int backward_id : backward_nodes_by_fact[var][values[var]]) {
+            backward_registry.unpack(backward_id, partial_values);
+            bool satisfied = true;
+            for (size_t var2 = var + 1; var2 < values.size(); ++var2) {
+                if (partial_values[var2] != PartialStateRegistry::UNDEFINED &&
+                    partial_values[var2] != values[var2]) {
+                    satisfied = false;
+                    break;
+                }
+            }
+            if (satisfied) {
+                update_best_meeting(id, backward_id);
+            }
+        }
+    }
+}
+
+void BidirectionalSearch::check_backward_meeting(
+    int id, const vector<int> &values) {
+    if (!use_partial_states) {
+        vector<PackedStateBin> buffer(state_registry.get_bins_per_state());
+        state_registry.pack_state_data(values, buffer.data());
+        StateID forward_id = state_registry.find_state(buffer.data());
+        if (forward_id != StateID::no_state) {
+            SearchNode node = search_space.get_node(
+                state_registry.lookup_state(forward_id));
+            if (!node.is_new() && !node.is_dead_end()) {
+                update_best_meeting(forward_id, id);
+            }
+        }
+        return;
+    }
+    // Scan the forward states with the rarest fact of the partial state.
+    int best_var = -1;
+    for (size_t var = 0; var < values.size(); ++var) {
+        if (values[var] != PartialStateRegistry::UNDEFINED &&
+            (best_var == -1 ||
+             forward_states_by_fact[var][values[var]].size() <
+             forward_states_by_fact[best_var][values[best_var]].size())) {
+            best_var = var;
+        }
+    }
+    if (best_var == -1) {
+        // All states satisfy the empty partial state.
+        const GlobalState &initial_state = state_registry.get_initial_state();
+        if (!search_space.get_node(initial_state).is_new()) {
+            update_best_meeting(initial_state.get_id(), id);
+        }
+        return;
+    }
+    for (StateID forward_id : forward_states_by_fact[best_var][values[best_var]]) {
+        GlobalState state = state_registry.lookup_state(forward_id);
+        bool satisfied = true;
+        for (size_t var = 0; var < values.size(); ++var) {
+            if (values[var] != PartialStateRegistry::UNDEFINED &&
+                state[var] != values[var]) {
+                satisfied = false;
+                break;
+            }
+        }
+        if (satisfied) {
+            update_best_meeting(forward_id, id);
+        }
+    }
+}
+
+void BidirectionalSearch::register_forward_state(
+    StateID id, const vector<int> &values) {
+    if (use_partial_states) {
+        for (size_t var = 0; var < values.size(); ++var) {
+            forward_states_by_fact[var][values[var]].push_back(id);
+        }
+    }
+}
+
+void BidirectionalSearch::register_backward_node(
+    int id, const vector<int> &values) {
+    if (use_partial_states) {
+        for (size_t var = 0; var < values.size(); ++var) {
+            if (values[var] != PartialStateRegistry::UNDEFINED) {
+                backward_nodes_by_fact[var][values[var]].push_back(id);
+                return;
+            }
+        }
+    }
+}
+
+int BidirectionalSearch::get_forward_priority(StateID id) {
+    GlobalState state = state_registry.lookup_state(id);
+    int g = search_space.get_node(state).get_g();
+    return max(g + forward_h[state], 2 * g);
+}
+
+int BidirectionalSearch::get_backward_priority(int id) const {
+    // With h = 0, the priority max(g + h, 2g) is 2g.
+    return 2 * backward_nodes[id].g;
+}
+
+int BidirectionalSearch::pop_forward_node(StateID &id) {
+    while (!forward_queue.empty()) {
+        pair<int, StateID> entry = forward_queue.pop();
+        // Skip closed nodes and entries with outdated g values.
+        if (search_space.get_node(state_registry.lookup_state(entry.second)).is_open() &&
+            entry.first == get_forward_priority(entry.second)) {
+            id = entry.second;
+            return entry.first;
+        }
+    }
+    return INF;
+}
+
+int BidirectionalSearch::pop_backward_node(int &id) {
+    while (!backward_queue.empty()) {
+        pair<int, int> entry = backward_queue.pop();
+        if (!backward_nodes[entry.second].closed &&
+            entry.first == get_backward_priority(entry.second)) {
+            id = entry.second;
+            return entry.first;
+        }
+    }
+    return INF;
+}
+
+void BidirectionalSearch::expand_forward(StateID id) {
+    GlobalState state = state_registry.lookup_state(id);
+    SearchNode node = search_space.get_node(state);
+    node.close();
+    statistics.inc_expanded();
+    ++num_forward_expansions;
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if (node.get_real_g() + op.get_cost() >= bound)
+            continue;
+        GlobalState succ_state = state_registry.get_successor_state(state, op);
+        statistics.inc_generated();
+        SearchNode succ_node = search_space.get_node(succ_state);
+        if (succ_node.is_dead_end())
+            continue;
+
+        int succ_g = node.get_g() + get_adjusted_cost(op);
+        if (succ_node.is_new()) {
+            EvaluationContext eval_context(succ_state, succ_g, false, &statistics);
+            statistics.inc_evaluated_states();
+            int h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+            if (h == EvaluationResult::INFTY) {
+                succ_node.mark_as_dead_end();
+                statistics.inc_dead_ends();
+                continue;
+            }
+            succ_node.open(node, op, get_adjusted_cost(op));
+            forward_h[succ_state] = h;
+            vector<int> succ_values = succ_state.unpack().get_values();
+            register_forward_state(succ_state.get_id(), succ_values);
+            check_forward_meeting(succ_state.get_id(), succ_values);
+        } else if (succ_g < succ_node.get_g()) {
+            if (succ_node.is_closed()) {
+                statistics.inc_reopened();
+            }
+            succ_node.reopen(node, op, get_adjusted_cost(op));
+            check_forward_meeting(
+                succ_state.get_id(), succ_state.unpack().get_values());
+        } else {
+            continue;
+        }
+        forward_queue.push(get_forward_priority(succ_state.get_id()),
+                           succ_state.get_id());
+    }
+}
+
+bool BidirectionalSearch::regress(
+    const vector<int> &values, const OperatorProxy &op,
+    vector<int> &result) const {
+    result = values;
+    bool is_relevant = false;
+    for (EffectProxy effect : op.get_effects()) {
+        FactPair fact = effect.get_fact().get_pair();
+        if (values[fact.var] == PartialStateRegistry::UNDEFINED) {
+            continue;
+        }
+        if (values[fact.var] != fact.value) {
+            return false;
+        }
+        is_relevant = true;
+        result[fact.var] = PartialStateRegistry::UNDEFINED;
+    }
+    if (!is_relevant) {
+        return false;
+    }
+    for (FactProxy pre : op.get_preconditions()) {
+        FactPair fact = pre.get_pair();
+        if (result[fact.var] != PartialStateRegistry::UNDEFINED &&
+            result[fact.var] != fact.value) {
+            return false;
+        }
+        result[fact.var] = fact.value;
+    }
+    return true;
+}
+
+void BidirectionalSearch::expand_backward(int id) {
+    backward_nodes[id].closed = true;
+    int g = backward_nodes[id].g;
+    int real_g = backward_nodes[id].real_g;
+    statistics.inc_expanded();
+    ++num_backward_expansions;
+
+    vector<int> values;
+    backward_registry.unpack(id, values);
+    vector<int> succ_values;
+    for (size_t var = 0; var < values.size(); ++var) {
+        if (values[var] == PartialStateRegistry::UNDEFINED) {
+            continue;
+        }
+        for (OperatorID op_id : achievers[var][values[var]]) {
+            // Only regress once through operators with several relevant effects.
+            int &mark = operator_marks[op_id.get_index()];
+            if (mark == num_backward_expansions) {
+                continue;
+            }
+            mark = num_backward_expansions;
+            OperatorProxy op = task_proxy.get_operators()[op_id];
+            if (real_g + op.get_cost() >= bound || !regress(values, op, succ_values))
+                continue;
+            statistics.inc_generated();
+
+            int succ_g = g + get_adjusted_cost(op);
+            pair<int, bool> result = backward_registry.insert(succ_values);
+            int succ_id = result.first;
+            if (result.second) {
+                backward_nodes.emplace_back(
+                    succ_g, real_g + op.get_cost(), id, op_id);
+                register_backward_node(succ_id, succ_values);
+            } else if (succ_g < backward_nodes[succ_id].g) {
+                BackwardNode &succ_node = backward_nodes[succ_id];
+                if (succ_node.closed) {
+                    statistics.inc_reopened();
+                }
+                succ_node.g = succ_g;
+                succ_node.real_g = real_g + op.get_cost();
+                succ_node.parent_id = id;
+                succ_node.creating_operator = op_id;
+                succ_node.closed = false;
+            } else {
+                continue;
+            }
+            check_backward_meeting(succ_id, succ_values);
+            backward_queue.push(get_backward_priority(succ_id), succ_id);
+        }
+    }
+}
+
+void BidirectionalSearch::set_meeting_plan() {
+    Plan plan;
+    search_space.trace_path(state_registry.lookup_state(best_forward_id), plan);
+    for (int id = best_backward_id; backward_nodes[id].parent_id != -1;
+         id = backward_nodes[id].parent_id) {
+        plan.push_back(backward_nodes[id].creating_operator);
+    }
+    set_plan(plan);
+}
+
+SearchStatus BidirectionalSearch::step() {
+    StateID forward_id = StateID::no_state;
+    int forward_priority = pop_forward_node(forward_id);
+    int backward_id = -1;
+    int backward_priority = pop_backward_node(backward_id);
+
+    int min_priority = min(forward_priority, backward_priority);
+    if (best_plan_cost != INF && best_plan_cost <= min_priority) {
+        utils::g_log << "Solution found with cost " << best_plan_cost << endl;
+        set_meeting_plan();
+        return SOLVED;
+    }
+    if (min_priority == INF) {
+        utils::g_log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+
+    if (forward_priority <= backward_priority) {
+        expand_forward(forward_id);
+        if (backward_id != -1) {
+            backward_queue.push(backward_priority, backward_id);
+        }
+    } else {
+        expand_backward(backward_id);
+        if (forward_id != StateID::no_state) {
+            forward_queue.push(forward_priority, forward_id);
+        }
+    }
+    return IN_PROGRESS;
+}
+
+void BidirectionalSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    search_space.print_statistics();
+    utils::g_log << "Forward expansions: " << num_forward_expansions << endl;
+    utils::g_log << "Backward expansions: " << num_backward_expansions << endl;
+    utils::g_log << "Registered backward nodes: " << backward_registry.size()
+                 << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Bidirectional search",
+        "Bidirectional search that meets in the middle (MM). The forward "
+        "direction progresses states from the initial state and uses the "
+        "given evaluator, the backward direction regresses partial states "
+        "from the goal without a heuristic. Both directions expand nodes in "
+        "the order of max(f, 2g) and the search stops once the cheapest "
+        "meeting of both directions is not more expensive than the lowest "
+        "priority of an open node, so plans are optimal for admissible "
+        "evaluators. With eval=blind(), the search is MM0.");
+    parser.document_language_support("action costs", "supported");
+    parser.document_language_support("conditional effects", "not supported");
+    parser.document_language_support("axioms", "not supported");
+    parser.document_note(
+        "Partial states",
+        "If the goal does not specify all variables or some operator changes "
+        "a variable without a precondition on it, backward nodes are partial "
+        "states. Then the search finds the meeting nodes with lists from "
+        "facts to nodes, which need one entry per variable for each forward "
+        "state. Otherwise, it finds them by hash lookups.");
+    parser.add_option<shared_ptr<Evaluator>>(
+        "eval", "evaluator for the forward direction");
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<BidirectionalSearch>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("bidirectional", _parse);
+}
@@ -0,0 +1,204 @@
+#ifndef SEARCH_ENGINES_BIDIRECTIONAL_SEARCH_H
+#define SEARCH_ENGINES_BIDIRECTIONAL_SEARCH_H
+
+#include "../per_state_information.h"
+#include "../search_engine.h"
+
+#include "../algorithms/int_hash_set.h"
+#include "../algorithms/int_packer.h"
+#include "../algorithms/priority_queues.h"
+#include "../algorithms/segmented_vector.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace options {
+class Options;
+}
+
+/*
+  Bidirectional search that meets in the middle (MM).
+
+  The forward search progresses states from the initial state, the
+  backward search regresses partial states from the goal. Each partial
+  state stands for the set of states that agree with it on its defined
+  variables. A forward state s meets a backward partial state p if s
+  satisfies p, and the cheapest such pair yields an upper bound U on the
+  plan cost.
+
+  Both directions order their nodes by pr(n) = max(f(n), 2g(n)) and the
+  search always expands the node with the lowest priority. Once U is at
+  most the lowest priority C of both open lists, the plan is optimal if
+  both heuristics are admissible. The forward direction uses the given
+  evaluator (front-to-end), the backward direction uses h = 0 since our
+  evaluators only estimate goal distances. With blind() in the forward
+  direction, the search is MM0.
+*/
+namespace bidirectional_search {
+/*
+  Registry for partial states. Variables that are not defined in a
+  partial state have the value UNDEFINED. We pack the values with one
+  extra value per domain and assign consecutive IDs to the partial states
+  in the order in which they are inserted.
+*/
+class PartialStateRegistry {
+public:
+    static const int UNDEFINED = -1;
+private:
+    static const int SCRATCH_ID = std::numeric_limits<int>::max();
+
+    using DataPool = segmented_vector::SegmentedArrayVector<PackedStateBin>;
+
+    struct DataAccessor {
+        const DataPool &data_pool;
+        const PackedStateBin *scratch_data;
+        DataAccessor(const DataPool &data_pool, const PackedStateBin *scratch_data)
+            : data_pool(data_pool),
+              scratch_data(scratch_data) {
+        }
+
+        const PackedStateBin *operator[](int id) const {
+            if (id == SCRATCH_ID) {
+                return scratch_data;
+            }
+            return data_pool[id];
+        }
+    };
+
+    struct SemanticHash {
+        DataAccessor data;
+        int num_bins;
+        SemanticHash(const DataAccessor &data, int num_bins)
+            : data(data),
+              num_bins(num_bins) {
+        }
+
+        int_hash_set::HashType operator()(int id) const;
+    };
+
+    struct SemanticEqual {
+        DataAccessor data;
+        int num_bins;
+        SemanticEqual(const DataAccessor &data, int num_bins)
+            : data(data),
+              num_bins(num_bins) {
+        }
+
+        bool operator()(int lhs, int rhs) const {
+            const PackedStateBin *lhs_data = data[lhs];
+            return std::equal(lhs_data, lhs_data + num_bins, data[rhs]);
+        }
+    };
+
+    const int num_variables;
+    int_packer::IntPacker packer;
+    DataPool data_pool;
+    std::vector<PackedStateBin> scratch_buffer;
+    int_hash_set::IntHashSet<SemanticHash, SemanticEqual> registered_states;
+
+    void pack_into_scratch_buffer(const std::vector<int> &values);
+public:
+    explicit PartialStateRegistry(const TaskProxy &task_proxy);
+
+    /*
+      Register the given partial state. Return its ID and whether it was
+      not registered before.
+    */
+    std::pair<int, bool> insert(const std::vector<int> &values);
+    // Return the ID of the given partial state or -1 if it is not registered.
+    int find(const std::vector<int> &values);
+    void unpack(int id, std::vector<int> &values) const;
+
+    int size() const {
+        return data_pool.size();
+    }
+};
+
+
+struct BackwardNode {
+    int g;
+    int real_g;
+    // Partial state and operator from which we regressed to this node.
+    int parent_id;
+    OperatorID creating_operator;
+    bool closed;
+
+    BackwardNode(int g, int real_g, int parent_id, OperatorID creating_operator)
+        : g(g),
+          real_g(real_g),
+          parent_id(parent_id),
+          creating_operator(creating_operator),
+          closed(false) {
+    }
+};
+
+
+class BidirectionalSearch : public SearchEngine {
+    std::shared_ptr<Evaluator> evaluator;
+
+    // Forward direction.
+    PerStateInformation<int> forward_h;
+    priority_queues::AdaptiveQueue<StateID> forward_queue;
+    int num_forward_expansions;
+
+    // Backward direction.
+    PartialStateRegistry backward_registry;
+    std::vector<BackwardNode> backward_nodes;
+    priority_queues::AdaptiveQueue<int> backward_queue;
+    int num_backward_expansions;
+    // Operators achieving each fact (for regression).
+    std::vector<std::vector<std::vector<OperatorID>>> achievers;
+    // Expansion in which we last considered each operator (for regression).
+    std::vector<int> operator_marks;
+
+    /*
+      If backward nodes can be partial states, we find the meeting nodes
+      with indices from facts to nodes. Every forward state appears in the
+      lists of all of its facts, every backward node only in the list of
+      its first defined fact. Otherwise, all nodes are complete states and
+      we find meeting nodes by hash lookups.
+    */
+    bool use_partial_states;
+    std::vector<std::vector<std::vector<StateID>>> forward_states_by_fact;
+    std::vector<std::vector<std::vector<int>>> backward_nodes_by_fact;
+
+    // Cheapest meeting found so far (upper bound U on the plan cost).
+    int best_plan_cost;
+    StateID best_forward_id;
+    int best_backward_id;
+
+    void update_best_meeting(StateID forward_id, int backward_id);
+    void check_forward_meeting(StateID id, const std::vector<int> &values);
+    void check_backward_meeting(int id, const std::vector<int> &values);
+
+    void register_forward_state(StateID id, const std::vector<int> &values);
+    void register_backward_node(int id, const std::vector<int> &values);
+
+    int get_forward_priority(StateID id);
+    int get_backward_priority(int id) const;
+    int pop_forward_node(StateID &id);
+    int pop_backward_node(int &id);
+
+    void expand_forward(StateID id);
+    void expand_backward(int id);
+    bool regress(const std::vector<int> &values, const OperatorProxy &op,
+                 std::vector<int> &result) const;
+    void set_meeting_plan();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit BidirectionalSearch(const options::Options &opts);
+    virtual ~BidirectionalSearch() override = default;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
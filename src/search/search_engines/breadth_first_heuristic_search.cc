@@ -0,0 +1,294 @@
+#include "breadth_first_heuristic_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+#include "../utils/timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <set>
+
+using namespace std;
+
+namespace breadth_first_heuristic_search {
+static const int INF = numeric_limits<int>::max();
+
+LayerSearchResult::LayerSearchResult()
+    : solved(false),
+      depth(-1),
+      next_f_bound(INF) {
+}
+
+BreadthFirstHeuristicSearch::BreadthFirstHeuristicSearch(const Options &opts)
+    : SearchEngine(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      f_bound(0),
+      max_num_stored_states(0) {
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (get_adjusted_cost(op) != 1) {
+            cerr << "Breadth-first heuristic search requires unit operator "
+                 << "costs. Use cost_type=one to ignore the operator costs."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+    }
+}
+
+void BreadthFirstHeuristicSearch::initialize() {
+    utils::g_log << "Conducting breadth-first heuristic search, (real) bound = "
+                 << bound << endl;
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "Breadth-first heuristic search does not support "
+             << "path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    initial_state_data.resize(state_registry.get_bins_per_state());
+    state_registry.copy_state_data(initial_state, initial_state_data.data());
+
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    f_bound = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+}
+
+LayerSearchResult BreadthFirstHeuristicSearch::search_layers(
+    const vector<PackedStateBin> &start_data, int start_g,
+    const vector<PackedStateBin> *target_data, int max_depth,
+    int relay_depth) {
+    LayerSearchResult result;
+    int num_bins = initial_state_data.size();
+    auto is_target = [&](const GlobalState &state, const PackedStateBin *data) {
+                         if (target_data) {
+                             return equal(target_data->begin(), target_data->end(),
+                                          data);
+                         }
+                         return task_properties::is_goal_state(task_proxy, state);
+                     };
+    auto set_result = [&](const StateRegistry &layer, const GlobalState &state,
+                          int depth, const shared_ptr<StateRegistry> &relay_layer) {
+                          result.solved = true;
+                          result.depth = depth;
+                          result.goal_data.resize(num_bins);
+                          layer.copy_state_data(state, result.goal_data.data());
+                          if (depth >= relay_depth) {
+                              GlobalState relay_state = relay_layer->lookup_state(
+                                  node_infos[state].relay_id);
+                              result.relay_data.resize(num_bins);
+                              relay_layer->copy_state_data(
+                                  relay_state, result.relay_data.data());
+                          }
+                      };
+
+    shared_ptr<StateRegistry> previous_layer;
+    shared_ptr<StateRegistry> current_layer = make_shared<StateRegistry>(task_proxy);
+    shared_ptr<StateRegistry> relay_layer;
+    GlobalState start_state = current_layer->insert_state(start_data.data());
+    if (relay_depth == 0) {
+        node_infos[start_state].relay_id = start_state.get_id();
+        relay_layer = current_layer;
+    }
+    if (is_target(start_state, start_data.data())) {
+        set_result(*current_layer, start_state, 0, relay_layer);
+        return result;
+    }
+
+    vector<PackedStateBin> buffer(num_bins);
+    vector<OperatorID> applicable_ops;
+    int num_open_states = 1;
+    for (int depth = 0; depth < max_depth && num_open_states > 0; ++depth) {
+        shared_ptr<StateRegistry> next_layer = make_shared<StateRegistry>(task_proxy);
+        int succ_depth = depth + 1;
+        int succ_g = start_g + succ_depth;
+        num_open_states = 0;
+        for (StateID id : *current_layer) {
+            GlobalState state = current_layer->lookup_state(id);
+            const BFHSNodeInfo info = node_infos[state];
+            if (info.pruned) {
+                continue;
+            }
+            statistics.inc_expanded();
+            applicable_ops.clear();
+            successor_generator.generate_applicable_ops(state, applicable_ops);
+            statistics.inc_generated(applicable_ops.size());
+            for (OperatorID op_id : applicable_ops) {
+                OperatorProxy op = task_proxy.get_operators()[op_id];
+                current_layer->compute_successor_data(state, op, buffer.data());
+                if ((previous_layer &&
+                     previous_layer->find_state(buffer.data()) != StateID::no_state) ||
+                    current_layer->find_state(buffer.data()) != StateID::no_state ||
+                    next_layer->find_state(buffer.data()) != StateID::no_state) {
+                    continue;
+                }
+                GlobalState succ_state = next_layer->insert_state(buffer.data());
+                BFHSNodeInfo &succ_info = node_infos[succ_state];
+                if (succ_depth == relay_depth) {
+                    succ_info.relay_id = succ_state.get_id();
+                } else if (succ_depth > relay_depth) {
+                    succ_info.relay_id = info.relay_id;
+                }
+
+                EvaluationContext eval_context(
+                    succ_state, succ_g, false, &statistics);
+                statistics.inc_evaluated_states();
+                int h = eval_context.get_evaluator_value_or_infinity(
+                    evaluator.get());
+                if (h == EvaluationResult::INFTY) {
+                    statistics.inc_dead_ends();
+                    succ_info.pruned = true;
+                } else if (succ_g + h > f_bound) {
+                    result.next_f_bound = min(result.next_f_bound, succ_g + h);
+                    succ_info.pruned = true;
+                } else if (is_target(succ_state, buffer.data())) {
+                    set_result(*next_layer, succ_state, succ_depth,
+                               succ_depth == relay_depth ? next_layer : relay_layer);
+                    return result;
+                } else {
+                    ++num_open_states;
+                }
+            }
+        }
+        if (succ_depth == relay_depth) {
+            relay_layer = next_layer;
+        }
+
+        size_t num_stored_states = current_layer->size() + next_layer->size();
+        if (previous_layer) {
+            num_stored_states += previous_layer->size();
+        }
+        if (relay_layer && relay_layer != previous_layer &&
+            relay_layer != current_layer && relay_layer != next_layer) {
+            num_stored_states += relay_layer->size();
+        }
+        max_num_stored_states = max(max_num_stored_states, num_stored_states);
+
+        previous_layer = move(current_layer);
+        current_layer = move(next_layer);
+    }
+    return result;
+}
+
+void BreadthFirstHeuristicSearch::reconstruct_path(
+    const vector<PackedStateBin> &start_data, int start_g,
+    const vector<PackedStateBin> &target_data, int length, Plan &plan) {
+    if (length == 0) {
+        assert(start_data == target_data);
+        return;
+    } else if (length == 1) {
+        StateRegistry registry(task_proxy);
+        GlobalState start_state = registry.insert_state(start_data.data());
+        vector<OperatorID> applicable_ops;
+        successor_generator.generate_applicable_ops(start_state, applicable_ops);
+        vector<PackedStateBin> buffer(start_data.size());
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = task_proxy.get_operators()[op_id];
+            registry.compute_successor_data(start_state, op, buffer.data());
+            if (buffer == target_data) {
+                plan.push_back(op_id);
+                return;
+            }
+        }
+    } else {
+        int relay_depth = length / 2;
+        LayerSearchResult result = search_layers(
+            start_data, start_g, &target_data, length, relay_depth);
+        if (result.solved && result.depth == length) {
+            assert(!result.relay_data.empty());
+            reconstruct_path(start_data, start_g, result.relay_data,
+                             relay_depth, plan);
+            reconstruct_path(result.relay_data, start_g + relay_depth,
+                             target_data, length - relay_depth, plan);
+            return;
+        }
+    }
+    cerr << "Could not reconstruct the plan." << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+SearchStatus BreadthFirstHeuristicSearch::step() {
+    if (f_bound == INF) {
+        utils::g_log << "Initial state is a dead end." << endl;
+        return FAILED;
+    }
+    if (f_bound >= bound) {
+        utils::g_log << "f bound reached the cost bound -- no solution!" << endl;
+        return FAILED;
+    }
+    utils::g_log << "f bound: " << f_bound << " ["
+                 << statistics.get_expanded() << " expanded so far]" << endl;
+
+    int relay_depth = f_bound / 2;
+    LayerSearchResult result = search_layers(
+        initial_state_data, 0, nullptr, INF, relay_depth);
+    if (result.solved) {
+        utils::g_log << "Solution found at depth " << result.depth << endl;
+        utils::Timer reconstruction_timer;
+        Plan plan;
+        if (result.relay_data.empty()) {
+            reconstruct_path(initial_state_data, 0, result.goal_data,
+                             result.depth, plan);
+        } else {
+            reconstruct_path(initial_state_data, 0, result.relay_data,
+                             relay_depth, plan);
+            reconstruct_path(result.relay_data, relay_depth, result.goal_data,
+                             result.depth - relay_depth, plan);
+        }
+        utils::g_log << "Time for reconstructing the plan: "
+                     << reconstruction_timer << endl;
+        set_plan(plan);
+        return SOLVED;
+    }
+    if (result.next_f_bound == INF) {
+        utils::g_log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    f_bound = result.next_f_bound;
+    return IN_PROGRESS;
+}
+
+void BreadthFirstHeuristicSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    utils::g_log << "Maximum number of stored states: "
+                 << max_num_stored_states << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Breadth-first heuristic search",
+        "Breadth-first iterative-deepening A* that only stores a few layers "
+        "of the search instead of all generated states and reconstructs "
+        "plans by divide and conquer. The search prunes states whose f value "
+        "exceeds the current f bound and raises the bound until it finds a "
+        "goal, so plans are optimal for admissible evaluators. Since it "
+        "searches layer by layer, the search only supports unit operator "
+        "costs (e.g., with cost_type=one).");
+    parser.document_note(
+        "Memory usage",
+        "The search stores the previous, current and next layer for "
+        "duplicate detection and a relay layer in the middle of the search "
+        "for reconstructing the plan. States can therefore be expanded more "
+        "than once within an iteration, in exchange for needing much less "
+        "memory than astar(eval).");
+    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<BreadthFirstHeuristicSearch>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("bfhs", _parse);
+}
@@ -0,0 +1,103 @@
+#ifndef SEARCH_ENGINES_BREADTH_FIRST_HEURISTIC_SEARCH_H
+#define SEARCH_ENGINES_BREADTH_FIRST_HEURISTIC_SEARCH_H
+
+#include "../per_state_information.h"
+#include "../search_engine.h"
+
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace options {
+class Options;
+}
+
+/*
+  Breadth-first heuristic search (BFHS) with divide-and-conquer solution
+  reconstruction for tasks with unit operator costs.
+
+  The search expands the states layer by layer in breadth-first order
+  and prunes all states whose f = g + h exceeds the current f bound. It
+  starts with the h value of the initial state as the bound and raises
+  the bound to the lowest f value of a pruned state until it finds a
+  goal (breadth-first iterative-deepening A*). With an admissible
+  evaluator, the first goal it finds is optimal.
+
+  Instead of a closed list, the search only stores the previous, the
+  current and the next layer, each in its own state registry, and uses
+  them for duplicate detection. Older layers are freed. Since states of
+  older layers can be reached again, some states may be expanded more
+  than once, but never at a depth above the f bound.
+
+  To reconstruct a plan without parent pointers, the search additionally
+  keeps a relay layer in the middle of the search. Each state after the
+  relay layer remembers its ancestor in the relay layer. Once a goal is
+  found, the plan is split at the relay state and both halves are
+  reconstructed recursively by searches from the start to the relay
+  state and from the relay state to the goal.
+*/
+namespace breadth_first_heuristic_search {
+struct BFHSNodeInfo {
+    // Ancestor in the relay layer (only set for states at or after it).
+    StateID relay_id;
+    // Pruned states are stored for duplicate detection but not expanded.
+    bool pruned;
+
+    BFHSNodeInfo()
+        : relay_id(StateID::no_state),
+          pruned(false) {
+    }
+};
+
+struct LayerSearchResult {
+    bool solved;
+    // Depth of the goal state relative to the start state.
+    int depth;
+    std::vector<PackedStateBin> goal_data;
+    // Empty if the goal was found before reaching the relay layer.
+    std::vector<PackedStateBin> relay_data;
+    // Lowest f value of a pruned state (infinity if there is none).
+    int next_f_bound;
+
+    LayerSearchResult();
+};
+
+class BreadthFirstHeuristicSearch : public SearchEngine {
+    std::shared_ptr<Evaluator> evaluator;
+
+    std::vector<PackedStateBin> initial_state_data;
+    int f_bound;
+    PerStateInformation<BFHSNodeInfo> node_infos;
+
+    // Maximum number of states stored in all layers at the same time.
+    size_t max_num_stored_states;
+
+    /*
+      Search breadth-first from the state with the given data and g value
+      to a goal state (target_data == nullptr) or to the state with the
+      given data, up to the given depth.
+    */
+    LayerSearchResult search_layers(
+        const std::vector<PackedStateBin> &start_data, int start_g,
+        const std::vector<PackedStateBin> *target_data, int max_depth,
+        int relay_depth);
+    // Append the operators of a path of the given length to plan.
+    void reconstruct_path(
+        const std::vector<PackedStateBin> &start_data, int start_g,
+        const std::vector<PackedStateBin> &target_data, int length,
+        Plan &plan);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit BreadthFirstHeuristicSearch(const options::Options &opts);
+    virtual ~BreadthFirstHeuristicSearch() override = default;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "eager_search.h"
 
+#include "../bitstate_state_registry.h"
 #include "../evaluation_context.h"
 #include "../evaluator.h"
 #include "../open_list_factory.h"
@@ -72,6 +73,31 @@ void EagerSearch::initialize() {
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
 
+    set<Evaluator *> cached_evals;
+    open_list->get_evaluators(cached_evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        cached_evals.insert(evaluator.get());
+    }
+    if (f_evaluator) {
+        cached_evals.insert(f_evaluator.get());
+    }
+    if (lazy_evaluator) {
+        cached_evals.insert(lazy_evaluator.get());
+    }
+    EvaluatorCache::assign_slots(cached_evals);
+
+    /*
+      We evaluate the new successors of each expansion in one batch (see
+      Evaluator::compute_results). Path-dependent evaluators must be
+      notified of a transition before its successor is evaluated, so we
+      only use batches if there are none.
+    */
+    if (path_dependent_evaluators.empty()) {
+        set<Evaluator *> open_list_evals;
+        open_list->get_evaluators(open_list_evals);
+        batch_evaluators.assign(open_list_evals.begin(), open_list_evals.end());
+    }
+
     const GlobalState &initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
@@ -81,7 +107,8 @@ void EagerSearch::initialize() {
       Note: we consider the initial state as reached by a preferred
       operator.
     */
-    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    EvaluationContext eval_context(
+        initial_state, 0, true, &statistics, false, &preferred_operators_pool);
 
     statistics.inc_evaluated_states();
 
@@ -105,6 +132,7 @@ void EagerSearch::initialize() {
 void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    open_list->print_statistics();
     pruning_method->print_statistics();
 }
 
@@ -116,6 +144,13 @@ SearchStatus EagerSearch::step() {
             return FAILED;
         }
         StateID id = open_list->remove_min();
+        /*
+          Alternation open lists contain states several times. We release
+          states when we close them or find that they are dead ends, so we
+          can skip released states without looking them up.
+        */
+        if (state_registry.is_released(id))
+            continue;
         // TODO is there a way we can avoid creating the state here and then
         //      recreate it outside of this function with node.get_state()?
         //      One way would be to store GlobalState objects inside SearchNodes
@@ -130,7 +165,9 @@ SearchStatus EagerSearch::step() {
           We can pass calculate_preferred=false here since preferred
           operators are computed when the state is expanded.
         */
-        EvaluationContext eval_context(s, node->get_g(), false, &statistics);
+        EvaluationContext eval_context(
+            s, node->get_g(), false, &statistics, false,
+            &preferred_operators_pool);
 
         if (lazy_evaluator) {
             /*
@@ -156,6 +193,7 @@ SearchStatus EagerSearch::step() {
                 if (open_list->is_dead_end(eval_context)) {
                     node->mark_as_dead_end();
                     statistics.inc_dead_ends();
+                    state_registry.release_state(id);
                     continue;
                 }
                 if (new_h != old_h) {
@@ -186,7 +224,8 @@ SearchStatus EagerSearch::step() {
     pruning_method->prune_operators(s, applicable_ops);
 
     // This evaluates the expanded state (again) to get preferred ops
-    EvaluationContext eval_context(s, node->get_g(), false, &statistics, true);
+    EvaluationContext eval_context(
+        s, node->get_g(), false, &statistics, true, &preferred_operators_pool);
     ordered_set::OrderedSet<OperatorID> preferred_operators;
     for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
         collect_preferred_operators(eval_context,
@@ -194,13 +233,60 @@ SearchStatus EagerSearch::step() {
                                     preferred_operators);
     }
 
+    /*
+      Generate all successors first, so that we can evaluate the new ones
+      in one batch. A successor is new iff registering it added a state to
+      the registry, so a state that several operators lead to only enters
+      the batch once.
+    */
+    vector<OperatorID> succ_op_ids;
+    vector<GlobalState> succ_states;
+    vector<EvaluationContext> succ_eval_contexts;
+    // Index of the evaluation context of each successor or -1.
+    vector<int> succ_eval_context_indices;
+    succ_eval_contexts.reserve(applicable_ops.size());
     for (OperatorID op_id : applicable_ops) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         if ((node->get_real_g() + op.get_cost()) >= bound)
             continue;
 
-        GlobalState succ_state = state_registry.get_successor_state(s, op);
+        size_t num_states_before = state_registry.size();
+        tl::optional<GlobalState> new_succ_state =
+            state_registry.try_get_successor_state(s, op);
         statistics.inc_generated();
+        if (!new_succ_state) {
+            // The registry pruned the state as a duplicate.
+            continue;
+        }
+        int eval_context_index = -1;
+        if (!batch_evaluators.empty() &&
+            state_registry.size() > num_states_before) {
+            eval_context_index = succ_eval_contexts.size();
+            succ_eval_contexts.emplace_back(
+                *new_succ_state, node->get_g() + get_adjusted_cost(op),
+                preferred_operators.contains(op_id), &statistics, false,
+                &preferred_operators_pool);
+        }
+        succ_op_ids.push_back(op_id);
+        succ_states.push_back(*new_succ_state);
+        succ_eval_context_indices.push_back(eval_context_index);
+    }
+
+    if (!succ_eval_contexts.empty()) {
+        vector<EvaluationContext *> batch;
+        batch.reserve(succ_eval_contexts.size());
+        for (EvaluationContext &eval_context : succ_eval_contexts) {
+            batch.push_back(&eval_context);
+        }
+        for (Evaluator *evaluator : batch_evaluators) {
+            EvaluationContext::compute_results(batch, evaluator);
+        }
+    }
+
+    for (size_t i = 0; i < succ_states.size(); ++i) {
+        OperatorID op_id = succ_op_ids[i];
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        const GlobalState &succ_state = succ_states[i];
         bool is_preferred = preferred_operators.contains(op_id);
 
         SearchNode succ_node = search_space.get_node(succ_state);
@@ -222,13 +308,20 @@ SearchStatus EagerSearch::step() {
             // TODO: Make this less fragile.
             int succ_g = node->get_g() + get_adjusted_cost(op);
 
-            EvaluationContext succ_eval_context(
-                succ_state, succ_g, is_preferred, &statistics);
+            if (succ_eval_context_indices[i] == -1) {
+                succ_eval_context_indices[i] = succ_eval_contexts.size();
+                succ_eval_contexts.emplace_back(
+                    succ_state, succ_g, is_preferred, &statistics, false,
+                    &preferred_operators_pool);
+            }
+            EvaluationContext &succ_eval_context =
+                succ_eval_contexts[succ_eval_context_indices[i]];
             statistics.inc_evaluated_states();
 
             if (open_list->is_dead_end(succ_eval_context)) {
                 succ_node.mark_as_dead_end();
                 statistics.inc_dead_ends();
+                state_registry.release_state(succ_state.get_id());
                 continue;
             }
             succ_node.open(*node, op, get_adjusted_cost(op));
@@ -254,7 +347,8 @@ SearchStatus EagerSearch::step() {
                 succ_node.reopen(*node, op, get_adjusted_cost(op));
 
                 EvaluationContext succ_eval_context(
-                    succ_state, succ_node.get_g(), is_preferred, &statistics);
+                    succ_state, succ_node.get_g(), is_preferred, &statistics,
+                    false, &preferred_operators_pool);
 
                 /*
                   Note: our old code used to retrieve the h value from
@@ -283,6 +377,11 @@ SearchStatus EagerSearch::step() {
         }
     }
 
+    /*
+      Registries that recycle the data of released states never let the
+      search reopen closed nodes, so we do not need s any more.
+    */
+    state_registry.release_state(s.get_id());
     return IN_PROGRESS;
 }
 
@@ -315,5 +414,6 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 void add_options_to_parser(OptionParser &parser) {
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
+    add_bitstate_options_to_parser(parser);
 }
 }
@@ -1,6 +1,7 @@
 #ifndef SEARCH_ENGINES_EAGER_SEARCH_H
 #define SEARCH_ENGINES_EAGER_SEARCH_H
 
+#include "../evaluator_cache.h"
 #include "../open_list.h"
 #include "../search_engine.h"
 
@@ -23,10 +24,13 @@ class EagerSearch : public SearchEngine {
     std::shared_ptr<Evaluator> f_evaluator;
 
     std::vector<Evaluator *> path_dependent_evaluators;
+    // Evaluators of the open list that we compute for all new successors at once.
+    std::vector<Evaluator *> batch_evaluators;
     std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
     std::shared_ptr<Evaluator> lazy_evaluator;
 
     std::shared_ptr<PruningMethod> pruning_method;
+    PreferredOperatorsPool preferred_operators_pool;
 
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
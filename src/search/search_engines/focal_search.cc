@@ -0,0 +1,254 @@
+#include "focal_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <cmath>
+#include <limits>
+#include <optional.hh>
+#include <set>
+
+using namespace std;
+
+namespace focal_search {
+static const int INF = numeric_limits<int>::max();
+
+FocalSearch::FocalSearch(const Options &opts)
+    : SearchEngine(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      weight(opts.get<double>("w")),
+      reopen_closed_nodes(opts.get<bool>("reopen_closed")),
+      focal_list(opts.get<shared_ptr<OpenListFactory>>("focal")->
+                 create_state_open_list()),
+      h_values(-1),
+      focal_bound(-1),
+      num_focal_insertions(0),
+      num_moved_to_focal(0),
+      num_stale_focal_entries(0),
+      focal_timer(false) {
+}
+
+void FocalSearch::initialize() {
+    utils::g_log << "Conducting focal search with weight " << weight
+                 << ", (real) bound = " << bound << endl;
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    focal_list->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "Focal search does not support path-dependent evaluators."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    int h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+    if (h == EvaluationResult::INFTY || focal_list->is_dead_end(eval_context)) {
+        utils::g_log << "Initial state is a dead end." << endl;
+    } else {
+        SearchNode node = search_space.get_node(initial_state);
+        node.open_initial();
+        h_values[initial_state] = h;
+        insert(eval_context, h);
+    }
+}
+
+bool FocalSearch::is_current(StateID id, int f) {
+    GlobalState state = state_registry.lookup_state(id);
+    SearchNode node = search_space.get_node(state);
+    return node.is_open() && node.get_g() + h_values[state] == f;
+}
+
+int FocalSearch::get_f_min() {
+    while (!open_buckets.empty()) {
+        auto it = open_buckets.begin();
+        int f = it->first;
+        vector<StateID> &bucket = it->second;
+        while (!bucket.empty()) {
+            if (is_current(bucket.back(), f)) {
+                return f;
+            }
+            bucket.pop_back();
+        }
+        open_buckets.erase(it);
+    }
+    return INF;
+}
+
+int FocalSearch::compute_focal_bound(int f_min) const {
+    if (f_min == INF) {
+        return INF;
+    }
+    // Allow for rounding errors, e.g., in 1.2 * 5.
+    double focal_bound = floor(weight * f_min + 1e-9);
+    if (focal_bound >= INF) {
+        return INF - 1;
+    }
+    return static_cast<int>(focal_bound);
+}
+
+void FocalSearch::update_focal_list() {
+    int new_focal_bound = compute_focal_bound(get_f_min());
+    if (new_focal_bound > focal_bound) {
+        focal_timer.resume();
+        for (auto it = open_buckets.upper_bound(focal_bound);
+             it != open_buckets.end() && it->first <= new_focal_bound; ++it) {
+            int f = it->first;
+            for (StateID id : it->second) {
+                if (is_current(id, f)) {
+                    GlobalState state = state_registry.lookup_state(id);
+                    int g = search_space.get_node(state).get_g();
+                    EvaluationContext eval_context(state, g, false, &statistics);
+                    focal_list->insert(eval_context, id);
+                    ++num_focal_insertions;
+                    ++num_moved_to_focal;
+                }
+            }
+        }
+        focal_timer.stop();
+    }
+    /*
+      If f_min decreased, the focal list can contain nodes above the new
+      bound. We skip them when they are removed and move them to the focal
+      list again once the bound grows.
+    */
+    focal_bound = new_focal_bound;
+}
+
+void FocalSearch::insert(EvaluationContext &eval_context, int f) {
+    StateID id = eval_context.get_state().get_id();
+    open_buckets[f].push_back(id);
+    if (f <= focal_bound) {
+        focal_list->insert(eval_context, id);
+        ++num_focal_insertions;
+    }
+}
+
+SearchStatus FocalSearch::step() {
+    update_focal_list();
+
+    tl::optional<SearchNode> node;
+    while (true) {
+        if (focal_list->empty()) {
+            utils::g_log << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+        StateID id = focal_list->remove_min();
+        GlobalState state = state_registry.lookup_state(id);
+        node.emplace(search_space.get_node(state));
+        // Skip closed nodes and nodes above the current focal bound.
+        if (!node->is_open() ||
+            node->get_g() + h_values[state] > focal_bound) {
+            ++num_stale_focal_entries;
+            continue;
+        }
+        node->close();
+        statistics.inc_expanded();
+        break;
+    }
+
+    GlobalState state = node->get_state();
+    if (check_goal_and_set_plan(state))
+        return SOLVED;
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if ((node->get_real_g() + op.get_cost()) >= bound)
+            continue;
+        GlobalState succ_state = state_registry.get_successor_state(state, op);
+        statistics.inc_generated();
+        SearchNode succ_node = search_space.get_node(succ_state);
+        if (succ_node.is_dead_end())
+            continue;
+
+        int succ_g = node->get_g() + get_adjusted_cost(op);
+        if (succ_node.is_new()) {
+            EvaluationContext eval_context(succ_state, succ_g, false, &statistics);
+            statistics.inc_evaluated_states();
+            int h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+            if (h == EvaluationResult::INFTY ||
+                focal_list->is_dead_end(eval_context)) {
+                succ_node.mark_as_dead_end();
+                statistics.inc_dead_ends();
+                continue;
+            }
+            succ_node.open(*node, op, get_adjusted_cost(op));
+            h_values[succ_state] = h;
+            insert(eval_context, succ_g + h);
+        } else if (succ_node.get_g() > succ_g) {
+            // We found a new cheapest path to an open or closed state.
+            if (succ_node.is_closed() && !reopen_closed_nodes) {
+                succ_node.update_parent(*node, op, get_adjusted_cost(op));
+                continue;
+            }
+            if (succ_node.is_closed()) {
+                statistics.inc_reopened();
+            }
+            succ_node.reopen(*node, op, get_adjusted_cost(op));
+            EvaluationContext eval_context(succ_state, succ_g, false, &statistics);
+            insert(eval_context, succ_g + h_values[succ_state]);
+        }
+    }
+    return IN_PROGRESS;
+}
+
+void FocalSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    search_space.print_statistics();
+    utils::g_log << "Focal list insertions: " << num_focal_insertions << endl;
+    utils::g_log << "Nodes moved to the focal list: " << num_moved_to_focal
+                 << endl;
+    utils::g_log << "Skipped focal list entries: " << num_stale_focal_entries
+                 << endl;
+    utils::g_log << "Time for moving nodes to the focal list: "
+                 << focal_timer << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Focal search",
+        "Bounded-suboptimal search that expands the best node of a focal "
+        "list. The focal list contains the open nodes whose f value is at "
+        "most w times the lowest f value of an open node and orders them "
+        "with the given open list. For an admissible evaluator eval, the "
+        "cost of the plan is at most w times the optimal plan cost.");
+    parser.document_note(
+        "Example",
+        "To find plans within 1.2 times the optimal cost, ordering the focal "
+        "list by the FF heuristic with ties broken by g, use\n```\n"
+        "--search \"focal(lmcut(), tiebreaking([ff(), g()]), w=1.2)\"\n```\n");
+    parser.add_option<shared_ptr<Evaluator>>(
+        "eval", "admissible evaluator for the f values");
+    parser.add_option<shared_ptr<OpenListFactory>>(
+        "focal", "open list that orders the focal list");
+    parser.add_option<double>(
+        "w",
+        "suboptimality bound",
+        "1.2",
+        Bounds("1.0", "infinity"));
+    parser.add_option<bool>(
+        "reopen_closed",
+        "reopen closed nodes",
+        "true");
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<FocalSearch>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("focal", _parse);
+}
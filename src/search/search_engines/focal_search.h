@@ -0,0 +1,74 @@
+#ifndef SEARCH_ENGINES_FOCAL_SEARCH_H
+#define SEARCH_ENGINES_FOCAL_SEARCH_H
+
+#include "../open_list.h"
+#include "../per_state_information.h"
+#include "../search_engine.h"
+
+#include "../utils/timer.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace options {
+class Options;
+}
+
+/*
+  Focal search for bounded-suboptimal planning.
+
+  The open list orders the open nodes by f = g + h for an admissible
+  evaluator h. The focal list contains the open nodes whose f value is at
+  most w times the lowest f value f_min of an open node and orders them by
+  a user-defined open list, usually with an inadmissible distance
+  estimate. The search always expands the best node of the focal list, so
+  the cost of a plan is at most w times the optimal plan cost.
+
+  Both lists use lazy deletion: the open list stores the open nodes in
+  buckets by f value and skips closed and outdated entries when looking
+  for f_min, and entries leave the focal list only when they are removed
+  as the best entry. When f_min grows, the nodes of the buckets between
+  the old and the new focal bound move into the focal list.
+*/
+namespace focal_search {
+class FocalSearch : public SearchEngine {
+    std::shared_ptr<Evaluator> evaluator;
+    const double weight;
+    const bool reopen_closed_nodes;
+
+    // Open nodes by f value. Entries may be closed or outdated.
+    std::map<int, std::vector<StateID>> open_buckets;
+    std::unique_ptr<StateOpenList> focal_list;
+    // Heuristic values of the admissible evaluator.
+    PerStateInformation<int> h_values;
+    // Nodes with an f value up to this bound have been moved to focal_list.
+    int focal_bound;
+
+    // Statistics for the maintenance of the focal list.
+    int num_focal_insertions;
+    int num_moved_to_focal;
+    int num_stale_focal_entries;
+    utils::Timer focal_timer;
+
+    bool is_current(StateID id, int f);
+    int get_f_min();
+    int compute_focal_bound(int f_min) const;
+    void update_focal_list();
+    void insert(EvaluationContext &eval_context, int f);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit FocalSearch(const options::Options &opts);
+    virtual ~FocalSearch() override = default;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
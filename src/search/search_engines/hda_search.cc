@@ -0,0 +1,548 @@
+#include "hda_search.h"
+
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../option_parser.h"
+
+#include "../algorithms/ordered_set.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace hda_search {
+/*
+  Number of shards of the shared state registry per worker. With several
+  shards per worker, two workers rarely register states in the same shard
+  at the same time.
+*/
+static const int SHARDS_PER_WORKER = 4;
+
+/*
+  A successor state sent from the worker that generated it to the worker
+  owning it. The state is already registered in the shared registry.
+*/
+struct Message {
+    Message *next;
+    StateID state_id;
+    int g;
+    int real_g;
+    StateID parent_state_id;
+    OperatorID creating_operator;
+    bool is_preferred;
+
+    Message(StateID state_id, int g, int real_g, StateID parent_state_id,
+            OperatorID creating_operator, bool is_preferred)
+        : next(nullptr),
+          state_id(state_id),
+          g(g),
+          real_g(real_g),
+          parent_state_id(parent_state_id),
+          creating_operator(creating_operator),
+          is_preferred(is_preferred) {
+    }
+};
+
+/*
+  Lock-free mailbox with many senders and a single receiver. Senders push
+  messages onto an intrusive stack, the receiver takes all of them at once.
+*/
+class Mailbox {
+    atomic<Message *> head;
+public:
+    Mailbox()
+        : head(nullptr) {
+    }
+
+    ~Mailbox() {
+        Message *message = take_all();
+        while (message) {
+            Message *next = message->next;
+            delete message;
+            message = next;
+        }
+    }
+
+    void push(Message *message) {
+        message->next = head.load(memory_order_relaxed);
+        while (!head.compare_exchange_weak(
+                   message->next, message,
+                   memory_order_release, memory_order_relaxed)) {
+        }
+    }
+
+    Message *take_all() {
+        return head.exchange(nullptr, memory_order_acquire);
+    }
+};
+
+class Worker {
+    HDASearch &engine;
+    const int index;
+
+    unique_ptr<StateOpenList> open_list;
+    shared_ptr<Evaluator> f_evaluator;
+    vector<shared_ptr<Evaluator>> preferred_operator_evaluators;
+
+    // Scratch space for computing successor states.
+    vector<PackedStateBin> successor_data;
+    int num_pruned;
+    int num_sent;
+
+    void insert(const GlobalState &state, int g, int real_g,
+                StateID parent_state_id, OperatorID creating_operator,
+                bool is_preferred);
+    int receive(Message *messages);
+    void expand_next();
+public:
+    SearchStatistics statistics;
+    Mailbox mailbox;
+
+    Worker(HDASearch &engine, int index);
+
+    void evaluate_initial_state(const GlobalState &initial_state);
+    void run();
+
+    int get_num_pruned() const {
+        return num_pruned;
+    }
+
+    int get_num_sent() const {
+        return num_sent;
+    }
+};
+
+Worker::Worker(HDASearch &engine, int index)
+    : engine(engine),
+      index(index),
+      successor_data(engine.shared_registry.get_bins_per_state()),
+      num_pruned(0),
+      num_sent(0),
+      statistics(engine.verbosity) {
+    if (engine.eval_config.empty()) {
+        open_list = engine.parse<shared_ptr<OpenListFactory>>(
+            engine.open_list_config)->create_state_open_list();
+        f_evaluator = engine.parse<shared_ptr<Evaluator>>(
+            engine.f_evaluator_config);
+        for (const options::ParseTree &config : engine.preferred_configs) {
+            preferred_operator_evaluators.push_back(
+                engine.parse<shared_ptr<Evaluator>>(config));
+        }
+    } else {
+        Options opts;
+        opts.set("eval", engine.parse<shared_ptr<Evaluator>>(engine.eval_config));
+        auto temp = search_common::create_astar_open_list_factory_and_f_eval(opts);
+        open_list = temp.first->create_state_open_list();
+        f_evaluator = temp.second;
+    }
+
+    set<Evaluator *> evals;
+    open_list->get_path_dependent_evaluators(evals);
+    f_evaluator->get_path_dependent_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        evaluator->get_path_dependent_evaluators(evals);
+    }
+    if (!evals.empty()) {
+        cerr << "HDA* does not support path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+}
+
+/*
+  Evaluators that store information per state (e.g., cached heuristic
+  values) subscribe to the state registry on their first evaluation, which
+  is not thread-safe. We therefore evaluate the initial state with all
+  evaluators of each worker before starting any thread. The result is not
+  counted in the statistics, since the owner of the initial state evaluates
+  it again.
+*/
+void Worker::evaluate_initial_state(const GlobalState &initial_state) {
+    set<Evaluator *> evals;
+    open_list->get_evaluators(evals);
+    evals.insert(f_evaluator.get());
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        evals.insert(evaluator.get());
+    }
+    EvaluationContext eval_context(initial_state, 0, true, nullptr, true);
+    for (Evaluator *evaluator : evals) {
+        eval_context.get_evaluator_value_or_infinity(evaluator);
+    }
+}
+
+void Worker::insert(const GlobalState &state, int g, int real_g,
+                    StateID parent_state_id, OperatorID creating_operator,
+                    bool is_preferred) {
+    HDANodeInfo &info = engine.node_infos[state];
+    if (info.status == HDANodeInfo::DEAD_END)
+        return;
+
+    bool is_new = (info.status == HDANodeInfo::NEW);
+    if (!is_new && g >= info.g)
+        return;
+
+    EvaluationContext eval_context(state, g, is_preferred, &statistics);
+    if (is_new) {
+        statistics.inc_evaluated_states();
+        if (open_list->is_dead_end(eval_context)) {
+            info.status = HDANodeInfo::DEAD_END;
+            statistics.inc_dead_ends();
+            return;
+        }
+    } else if (info.status == HDANodeInfo::CLOSED) {
+        // Nodes can be reached on cheaper paths after they were expanded.
+        statistics.inc_reopened();
+    }
+    info.status = HDANodeInfo::OPEN;
+    info.g = g;
+    info.real_g = real_g;
+    info.parent_state_id = parent_state_id;
+    info.creating_operator = creating_operator;
+    open_list->insert(eval_context, state.get_id());
+}
+
+int Worker::receive(Message *messages) {
+    int num_messages = 0;
+    while (messages) {
+        Message *next = messages->next;
+        insert(engine.shared_registry.lookup_state(messages->state_id),
+               messages->g, messages->real_g, messages->parent_state_id,
+               messages->creating_operator, messages->is_preferred);
+        delete messages;
+        messages = next;
+        ++num_messages;
+    }
+    return num_messages;
+}
+
+void Worker::expand_next() {
+    StateID id = open_list->remove_min();
+    GlobalState state = engine.shared_registry.lookup_state(id);
+    HDANodeInfo &info = engine.node_infos[state];
+    // Skip nodes that were closed or reopened since this entry was inserted.
+    if (info.status != HDANodeInfo::OPEN)
+        return;
+    int g = info.g;
+    int real_g = info.real_g;
+
+    EvaluationContext eval_context(state, g, false, &statistics);
+    int f = eval_context.get_evaluator_value_or_infinity(f_evaluator.get());
+    int incumbent_cost = engine.incumbent_cost.load(memory_order_relaxed);
+    if (f >= incumbent_cost) {
+        /*
+          The node cannot lead to a cheaper solution. We leave it open so
+          that it is reinserted if it is reached on a cheaper path.
+        */
+        ++num_pruned;
+        return;
+    }
+
+    info.status = HDANodeInfo::CLOSED;
+    statistics.inc_expanded();
+
+    if (task_properties::is_goal_state(engine.task_proxy, state)) {
+        engine.report_solution(id, g);
+        return;
+    }
+
+    vector<OperatorID> applicable_ops;
+    engine.successor_generator.generate_applicable_ops(state, applicable_ops);
+    statistics.inc_generated_ops(applicable_ops.size());
+
+    ordered_set::OrderedSet<OperatorID> preferred_operators;
+    if (!preferred_operator_evaluators.empty()) {
+        EvaluationContext preferred_context(state, g, false, &statistics, true);
+        for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+            collect_preferred_operators(
+                preferred_context, evaluator.get(), preferred_operators);
+        }
+    }
+
+    OperatorsProxy operators = engine.task_proxy.get_operators();
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = operators[op_id];
+        if (real_g + op.get_cost() >= engine.bound)
+            continue;
+        int succ_g = g + engine.get_adjusted_cost(op);
+        if (succ_g >= incumbent_cost)
+            continue;
+        int succ_real_g = real_g + op.get_cost();
+
+        engine.shared_registry.compute_successor_data(
+            state, op, successor_data.data());
+        statistics.inc_generated();
+        bool is_preferred = preferred_operators.contains(op_id);
+
+        int owner = engine.get_owner(successor_data.data());
+        GlobalState succ_state =
+            engine.shared_registry.insert_state(successor_data.data());
+        if (owner == index) {
+            insert(succ_state, succ_g, succ_real_g, id, op_id, is_preferred);
+        } else {
+            /*
+              Count the message as outstanding work before the receiver can
+              see it. Since this worker is active, the counter is positive
+              until the receiver has processed the message.
+            */
+            engine.outstanding_work.fetch_add(1);
+            engine.workers[owner]->mailbox.push(
+                new Message(succ_state.get_id(), succ_g, succ_real_g,
+                            id, op_id, is_preferred));
+            ++num_sent;
+        }
+    }
+}
+
+void Worker::run() {
+    bool active = true;
+    while (!engine.abort_search.load(memory_order_relaxed)) {
+        Message *messages = mailbox.take_all();
+        if (messages) {
+            if (!active) {
+                /* The messages are still counted, so the counter cannot
+                   have dropped to zero in the meantime. */
+                engine.outstanding_work.fetch_add(1);
+                active = true;
+            }
+            int num_messages = receive(messages);
+            engine.outstanding_work.fetch_sub(num_messages);
+        }
+
+        if (active) {
+            if (open_list->empty()) {
+                active = false;
+                engine.outstanding_work.fetch_sub(1);
+            } else {
+                expand_next();
+            }
+        } else if (engine.outstanding_work.load() == 0) {
+            break;
+        } else {
+            this_thread::yield();
+        }
+    }
+}
+
+
+HDASearch::HDASearch(const Options &opts, options::Registry &registry,
+                     const options::Predefinitions &predefinitions)
+    : SearchEngine(opts),
+      eval_config(opts.get<ParseTree>("eval", ParseTree())),
+      open_list_config(opts.get<ParseTree>("open", ParseTree())),
+      f_evaluator_config(opts.get<ParseTree>("f_eval", ParseTree())),
+      preferred_configs(opts.get_list<ParseTree>("preferred")),
+      registry(registry),
+      predefinitions(predefinitions),
+      num_workers(opts.get<int>("num_threads") ?
+                  opts.get<int>("num_threads") :
+                  max(1U, thread::hardware_concurrency())),
+      shared_registry(task_proxy, num_workers * SHARDS_PER_WORKER),
+      node_infos(shared_registry),
+      outstanding_work(0),
+      abort_search(false),
+      incumbent_cost(numeric_limits<int>::max()),
+      incumbent_state_id(StateID::no_state) {
+    task_properties::verify_no_axioms(task_proxy);
+    if (opts.get<StateHashing>("state_hashing") != StateHashing::PACKED_DATA) {
+        cerr << "HDA* only supports state_hashing=packed_data." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+}
+
+HDASearch::~HDASearch() {
+}
+
+template<typename T>
+T HDASearch::parse(const ParseTree &config) {
+    OptionParser parser(config, registry, predefinitions, false);
+    return parser.start_parsing<T>();
+}
+
+int HDASearch::get_owner(const PackedStateBin *buffer) const {
+    StateRegistry::HashType hash = StateRegistry::hash_state_data(
+        buffer, shared_registry.get_bins_per_state());
+    /*
+      IntHashSet uses the low bits of the hash to choose a bucket. Since all
+      states of one worker end up in the same hash set, we use the high bits
+      to choose the owner. Otherwise, all states of a worker would share
+      their low bits and cluster in the hash set.
+    */
+    uint64_t high_bits =
+        hash >> (numeric_limits<StateRegistry::HashType>::digits - 32);
+    return (high_bits * num_workers) >> 32;
+}
+
+void HDASearch::report_solution(StateID goal_id, int g) {
+    lock_guard<mutex> lock(incumbent_mutex);
+    if (g < incumbent_cost.load()) {
+        incumbent_cost.store(g);
+        incumbent_state_id = goal_id;
+    }
+}
+
+void HDASearch::extract_plan() {
+    Plan plan;
+    StateID id = incumbent_state_id;
+    for (;;) {
+        GlobalState state = shared_registry.lookup_state(id);
+        const HDANodeInfo &info = node_infos[state];
+        if (info.creating_operator == OperatorID::no_operator) {
+            assert(info.parent_state_id == StateID::no_state);
+            break;
+        }
+        plan.push_back(info.creating_operator);
+        id = info.parent_state_id;
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+void HDASearch::initialize() {
+    utils::g_log << "Conducting hash-distributed best first search with "
+                 << num_workers << " worker threads, (real) bound = "
+                 << bound << endl;
+    /*
+      Evaluators print information while they are constructed, so we create
+      all workers before starting any thread.
+    */
+    for (int i = 0; i < num_workers; ++i) {
+        workers.push_back(utils::make_unique_ptr<Worker>(*this, i));
+    }
+    const GlobalState &initial_state = shared_registry.get_initial_state();
+    for (const unique_ptr<Worker> &worker : workers) {
+        worker->evaluate_initial_state(initial_state);
+    }
+}
+
+SearchStatus HDASearch::step() {
+    const GlobalState &initial_state = shared_registry.get_initial_state();
+    vector<PackedStateBin> initial_data(shared_registry.get_bins_per_state());
+    shared_registry.copy_state_data(initial_state, initial_data.data());
+    int owner = get_owner(initial_data.data());
+    // All workers start active and the initial state counts as a message.
+    outstanding_work.store(num_workers + 1);
+    workers[owner]->mailbox.push(
+        new Message(initial_state.get_id(), 0, 0, StateID::no_state,
+                    OperatorID::no_operator, true));
+
+    utils::CountdownTimer timer(max_time);
+    vector<thread> threads;
+    for (const unique_ptr<Worker> &worker : workers) {
+        threads.emplace_back(&Worker::run, worker.get());
+    }
+    bool timed_out = false;
+    while (outstanding_work.load() != 0) {
+        if (timer.is_expired()) {
+            abort_search.store(true);
+            timed_out = true;
+            break;
+        }
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        const SearchStatistics &worker_stats = worker->statistics;
+        statistics.inc_expanded(worker_stats.get_expanded());
+        statistics.inc_evaluated_states(worker_stats.get_evaluated_states());
+        statistics.inc_evaluations(worker_stats.get_evaluations());
+        statistics.inc_generated(worker_stats.get_generated());
+        statistics.inc_generated_ops(worker_stats.get_generated_ops());
+        statistics.inc_reopened(worker_stats.get_reopened());
+        statistics.inc_dead_ends(worker_stats.get_dead_ends());
+    }
+
+    if (timed_out) {
+        /*
+          The workers stopped before expanding all nodes with lower f values
+          than the incumbent, so we cannot prove that it is optimal.
+        */
+        if (incumbent_state_id != StateID::no_state) {
+            utils::g_log << "Solution found, but it is not proven optimal."
+                         << endl;
+            extract_plan();
+        }
+        return TIMEOUT;
+    }
+    if (incumbent_state_id != StateID::no_state) {
+        utils::g_log << "Solution found!" << endl;
+        extract_plan();
+        /* All nodes with lower f values have been expanded, so the
+           solution is optimal for admissible evaluators. */
+        return SOLVED;
+    }
+    utils::g_log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+void HDASearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        const Worker &worker = *workers[i];
+        utils::g_log << "Worker " << i << ": "
+                     << worker.statistics.get_expanded() << " expanded, "
+                     << worker.get_num_sent() << " sent, "
+                     << worker.get_num_pruned() << " pruned" << endl;
+    }
+    shared_registry.print_statistics();
+}
+
+void add_options_to_parser(OptionParser &parser) {
+    parser.add_option<int>(
+        "num_threads",
+        "number of worker threads (0 uses one thread per hardware thread)",
+        "0",
+        Bounds("0", "infinity"));
+    SearchEngine::add_options_to_parser(parser);
+}
+
+static void verify_no_predefinitions(
+    OptionParser &parser, const ParseTree &config) {
+    for (ParseTree::iterator it = config.begin(); it != config.end(); ++it) {
+        if (parser.get_predefinitions().contains(it->value)) {
+            parser.error(
+                "HDA* parses a copy of its configuration for each worker "
+                "thread and cannot use the predefined object " + it->value);
+        }
+    }
+}
+
+template<typename T>
+static void verify_config(OptionParser &parser, const ParseTree &config) {
+    verify_no_predefinitions(parser, config);
+    OptionParser test_parser(config, parser.get_registry(),
+                             parser.get_predefinitions(), true);
+    test_parser.start_parsing<T>();
+}
+
+void verify_configs(OptionParser &parser, const Options &opts) {
+    if (opts.contains("eval")) {
+        verify_config<shared_ptr<Evaluator>>(parser, opts.get<ParseTree>("eval"));
+    }
+    if (opts.contains("open")) {
+        verify_config<shared_ptr<OpenListFactory>>(
+            parser, opts.get<ParseTree>("open"));
+    }
+    if (opts.contains("f_eval")) {
+        verify_config<shared_ptr<Evaluator>>(parser, opts.get<ParseTree>("f_eval"));
+    }
+    for (const ParseTree &config : opts.get_list<ParseTree>("preferred")) {
+        verify_config<shared_ptr<Evaluator>>(parser, config);
+    }
+}
+}
@@ -0,0 +1,124 @@
+#ifndef SEARCH_ENGINES_HDA_SEARCH_H
+#define SEARCH_ENGINES_HDA_SEARCH_H
+
+#include "../concurrent_per_state_information.h"
+#include "../concurrent_state_registry.h"
+#include "../operator_id.h"
+#include "../option_parser_util.h"
+#include "../search_engine.h"
+
+#include "../options/predefinitions.h"
+#include "../options/registries.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+/*
+  Hash-distributed A* (HDA*).
+
+  Each worker thread owns a partition of the state space and runs a
+  best-first search on it with its own open list and evaluators. The owner
+  of a state is determined by the hash value that StateRegistry uses for
+  duplicate detection (see StateRegistry::hash_state_data), so every state
+  is evaluated and expanded by exactly one worker. All workers register
+  states in one shared ConcurrentStateRegistry: a worker registers the
+  successors it generates and sends the IDs of the successors owned by other
+  workers to them through lock-free mailboxes. Only the owner of a state
+  accesses its search information.
+
+  A worker prunes all nodes whose f value is not lower than the cost of
+  the best solution found so far (the incumbent). The search terminates
+  when no worker has any open nodes left and no messages are in flight,
+  which is detected with a single counter of outstanding work. With an
+  admissible heuristic and an open list that is ordered by f, the
+  incumbent is then an optimal solution.
+
+  Evaluators and open lists are not thread-safe, so each worker parses
+  its own copy of the configuration. For this reason the configuration
+  must not refer to predefined evaluators.
+*/
+namespace hda_search {
+class Worker;
+
+struct HDANodeInfo {
+    enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
+
+    NodeStatus status;
+    int g;
+    int real_g;
+    StateID parent_state_id;
+    OperatorID creating_operator;
+
+    HDANodeInfo()
+        : status(NEW), g(-1), real_g(-1),
+          parent_state_id(StateID::no_state),
+          creating_operator(OperatorID::no_operator) {
+    }
+};
+
+class HDASearch : public SearchEngine {
+    friend class Worker;
+
+    /*
+      Either eval_config is given (hda_astar) or open_list_config and
+      f_evaluator_config are given (hda).
+    */
+    const options::ParseTree eval_config;
+    const options::ParseTree open_list_config;
+    const options::ParseTree f_evaluator_config;
+    const std::vector<options::ParseTree> preferred_configs;
+    /*
+      We need to copy the registry and predefinitions here since they live
+      longer than the objects referenced in the constructor.
+    */
+    options::Registry registry;
+    options::Predefinitions predefinitions;
+    const int num_workers;
+
+    ConcurrentStateRegistry shared_registry;
+    // Each entry is only accessed by the worker owning the state.
+    ConcurrentPerStateInformation<HDANodeInfo> node_infos;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /*
+      Number of active workers plus number of messages in flight. Once this
+      drops to zero, it can never increase again (see Worker::run).
+    */
+    std::atomic<long long> outstanding_work;
+    std::atomic<bool> abort_search;
+    // Adjusted cost (g value) of the best solution found so far.
+    std::atomic<int> incumbent_cost;
+    std::mutex incumbent_mutex;
+    StateID incumbent_state_id;
+
+    template<typename T>
+    T parse(const options::ParseTree &config);
+
+    int get_owner(const PackedStateBin *buffer) const;
+    void report_solution(StateID goal_id, int g);
+    void extract_plan();
+
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    HDASearch(const options::Options &opts, options::Registry &registry,
+              const options::Predefinitions &predefinitions);
+    virtual ~HDASearch() override;
+
+    virtual void print_statistics() const override;
+};
+
+extern void add_options_to_parser(options::OptionParser &parser);
+extern void verify_configs(options::OptionParser &parser,
+                           const options::Options &opts);
+}
+
+#endif
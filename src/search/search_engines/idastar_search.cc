@@ -0,0 +1,295 @@
+#include "idastar_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <set>
+
+using namespace std;
+
+namespace idastar_search {
+static const int INF = numeric_limits<int>::max();
+
+/*
+  Maximum number of states in the scratch registry before we replace it.
+  A registered state costs its packed data, a hash set bucket and the
+  per-state entries of the evaluators (e.g., cached heuristic values), so
+  for typical tasks 100000 states need a few MB, well below the default
+  size of the transposition table. Replacing the registry (allocating an
+  empty one and releasing the per-state entries of the old one) costs
+  little compared to 100000 evaluations.
+*/
+static const size_t MAX_SCRATCH_REGISTRY_SIZE = 100000;
+
+TranspositionTable::TranspositionTable(int num_bins, size_t num_bytes)
+    : num_bins(num_bins),
+      num_buckets(num_bytes /
+                  (2 * (num_bins * sizeof(PackedStateBin) + 2 * sizeof(int)))),
+      entry_data(2 * num_buckets * num_bins),
+      entry_g(2 * num_buckets, 0),
+      entry_iteration(2 * num_buckets, 0),
+      iteration(0),
+      num_hits(0),
+      num_stores(0) {
+}
+
+void TranspositionTable::start_iteration() {
+    ++iteration;
+}
+
+void TranspositionTable::store(size_t entry, const PackedStateBin *data, int g) {
+    copy(data, data + num_bins, &entry_data[entry * num_bins]);
+    entry_g[entry] = g;
+    entry_iteration[entry] = iteration;
+    ++num_stores;
+}
+
+bool TranspositionTable::lookup_and_store(
+    const PackedStateBin *data, size_t hash, int g) {
+    if (num_buckets == 0) {
+        return false;
+    }
+    size_t first = 2 * (hash % num_buckets);
+    for (size_t entry = first; entry < first + 2; ++entry) {
+        if (is_current(entry) &&
+            equal(data, data + num_bins, &entry_data[entry * num_bins])) {
+            if (entry_g[entry] <= g) {
+                ++num_hits;
+                return true;
+            }
+            entry_g[entry] = g;
+            return false;
+        }
+    }
+    size_t second = first + 1;
+    if (!is_current(first) || g < entry_g[first]) {
+        if (is_current(first)) {
+            store(second, &entry_data[first * num_bins], entry_g[first]);
+        }
+        store(first, data, g);
+    } else {
+        store(second, data, g);
+    }
+    return false;
+}
+
+void TranspositionTable::print_statistics() const {
+    utils::g_log << "Transposition table entries: " << 2 * num_buckets << endl;
+    utils::g_log << "Transposition table stores: " << num_stores << endl;
+    utils::g_log << "Transposition table hits: " << num_hits << endl;
+}
+
+
+IDAStarSearch::IDAStarSearch(const Options &opts)
+    : SearchEngine(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      f_bound(0),
+      next_f_bound(INF),
+      num_iterations(0) {
+    int transposition_table_mb = opts.get<int>("transposition_table_mb");
+    if (transposition_table_mb > 0) {
+        transposition_table = utils::make_unique_ptr<TranspositionTable>(
+            state_registry.get_bins_per_state(),
+            static_cast<size_t>(transposition_table_mb) * 1024 * 1024);
+    }
+}
+
+IDAStarSearch::~IDAStarSearch() {
+}
+
+void IDAStarSearch::initialize() {
+    utils::g_log << "Conducting IDA* search, (real) bound = " << bound << endl;
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "IDA* does not support path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    f_bound = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+
+    path.resize(1);
+    PathNode &root = path[0];
+    root.values = initial_state.unpack().get_values();
+    root.data.resize(state_registry.get_bins_per_state());
+    state_registry.copy_state_data(initial_state, root.data.data());
+    root.hash = StateRegistry::hash_state_data(root.data.data(), root.data.size());
+    root.g = 0;
+    root.real_g = 0;
+}
+
+void IDAStarSearch::compute_successor(
+    const PathNode &node, const OperatorProxy &op, PathNode &succ_node) {
+    State state = task_proxy.create_state(vector<int>(node.values));
+    succ_node.values = node.values;
+    for (EffectProxy effect : op.get_effects()) {
+        if (does_fire(effect, state)) {
+            FactPair fact = effect.get_fact().get_pair();
+            succ_node.values[fact.var] = fact.value;
+        }
+    }
+    // Packing the state evaluates the axioms, so we unpack it again.
+    succ_node.data.resize(node.data.size());
+    state_registry.pack_state_data(succ_node.values, succ_node.data.data());
+    state_registry.unpack_state_data(succ_node.data.data(), succ_node.values.data());
+    succ_node.hash = StateRegistry::hash_state_data(
+        succ_node.data.data(), succ_node.data.size());
+    succ_node.g = node.g + get_adjusted_cost(op);
+    succ_node.real_g = node.real_g + op.get_cost();
+}
+
+bool IDAStarSearch::is_on_path(const PathNode &node, int depth) const {
+    for (int i = 0; i < depth; ++i) {
+        if (path[i].hash == node.hash && path[i].data == node.data) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int IDAStarSearch::evaluate(const PathNode &node) {
+    if (!scratch_registry ||
+        scratch_registry->size() >= MAX_SCRATCH_REGISTRY_SIZE) {
+        scratch_registry = utils::make_unique_ptr<StateRegistry>(task_proxy);
+    }
+    GlobalState state = scratch_registry->insert_state(node.data.data());
+    EvaluationContext eval_context(state, node.g, false, &statistics);
+    statistics.inc_evaluated_states();
+    return eval_context.get_evaluator_value_or_infinity(evaluator.get());
+}
+
+bool IDAStarSearch::search(int depth) {
+    {
+        State state = task_proxy.create_state(vector<int>(path[depth].values));
+        if (task_properties::is_goal_state(task_proxy, state)) {
+            return true;
+        }
+    }
+    statistics.inc_expanded();
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(
+        task_proxy.create_state(vector<int>(path[depth].values)),
+        applicable_ops);
+    statistics.inc_generated(applicable_ops.size());
+    if (static_cast<int>(path.size()) == depth + 1) {
+        path.emplace_back();
+    }
+
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if (path[depth].real_g + op.get_cost() >= bound) {
+            continue;
+        }
+        PathNode &succ_node = path[depth + 1];
+        compute_successor(path[depth], op, succ_node);
+        if (is_on_path(succ_node, depth + 1)) {
+            continue;
+        }
+        if (transposition_table &&
+            transposition_table->lookup_and_store(
+                succ_node.data.data(), succ_node.hash, succ_node.g)) {
+            continue;
+        }
+        int h = evaluate(succ_node);
+        if (h == EvaluationResult::INFTY) {
+            statistics.inc_dead_ends();
+            continue;
+        }
+        int f = succ_node.g + h;
+        if (f > f_bound) {
+            next_f_bound = min(next_f_bound, f);
+            continue;
+        }
+        path_operators.push_back(op_id);
+        if (search(depth + 1)) {
+            return true;
+        }
+        path_operators.pop_back();
+    }
+    return false;
+}
+
+SearchStatus IDAStarSearch::step() {
+    if (f_bound == INF) {
+        utils::g_log << "Initial state is a dead end." << endl;
+        return FAILED;
+    }
+    if (f_bound >= bound) {
+        utils::g_log << "f bound reached the cost bound -- no solution!" << endl;
+        return FAILED;
+    }
+    ++num_iterations;
+    utils::g_log << "f bound: " << f_bound << " ["
+                 << statistics.get_expanded() << " expanded so far]" << endl;
+    next_f_bound = INF;
+    path_operators.clear();
+    if (transposition_table) {
+        transposition_table->start_iteration();
+    }
+    if (search(0)) {
+        set_plan(path_operators);
+        return SOLVED;
+    }
+    if (next_f_bound == INF) {
+        utils::g_log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    f_bound = next_f_bound;
+    return IN_PROGRESS;
+}
+
+void IDAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    utils::g_log << "IDA* iterations: " << num_iterations << endl;
+    if (transposition_table) {
+        transposition_table->print_statistics();
+    }
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Iterative-deepening A* (IDA*)",
+        "Depth-first iterative deepening on the f value. The search only "
+        "stores the current path and an optional transposition table of "
+        "fixed size, so its memory usage is almost constant. Plans are "
+        "optimal for admissible evaluators.");
+    parser.document_note(
+        "Transposition table",
+        "The transposition table stores the packed data and the lowest g "
+        "value of states visited in the current iteration. A state reached "
+        "again with a g value that is not lower is pruned. Each bucket of "
+        "the table holds two states: one that prefers states with low g "
+        "values and one that always holds the most recent state.");
+    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+    parser.add_option<int>(
+        "transposition_table_mb",
+        "memory for the transposition table in MiB (0 disables it)",
+        "64",
+        Bounds("0", "infinity"));
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<IDAStarSearch>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("idastar", _parse);
+}
@@ -0,0 +1,117 @@
+#ifndef SEARCH_ENGINES_IDASTAR_SEARCH_H
+#define SEARCH_ENGINES_IDASTAR_SEARCH_H
+
+#include "../search_engine.h"
+
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace options {
+class Options;
+}
+
+/*
+  Iterative-deepening A* (IDA*).
+
+  The search runs depth-first searches that prune all states whose
+  f = g + h exceeds the current f bound. The bound starts with the h
+  value of the initial state and is raised to the lowest f value of a
+  pruned state after each unsuccessful iteration. With an admissible
+  evaluator, the first plan found is optimal.
+
+  The search only stores the states on the current path. These are kept
+  unpacked (for generating successors) and packed (for duplicate
+  checks). States on the current path are never revisited, which breaks
+  cycles (even with zero-cost operators).
+
+  Evaluators need registered states, so we register each state in a
+  scratch state registry before evaluating it. We replace the scratch
+  registry by an empty one whenever it holds too many states, which
+  keeps memory usage bounded.
+
+  Optionally, the search uses a transposition table of fixed size that
+  remembers states visited in the current iteration together with their
+  lowest g value. If a state is reached again with a g value that is not
+  lower, its subtree has already been searched with at least the same
+  remaining budget, so it can be pruned.
+*/
+namespace idastar_search {
+/*
+  Fixed-size transposition table with two entries per bucket. The first
+  entry of a bucket prefers states with lower g values (whose subtrees
+  are larger), the second one always holds the most recent state.
+  Entries from earlier iterations are ignored and overwritten.
+*/
+class TranspositionTable {
+    const int num_bins;
+    size_t num_buckets;
+    std::vector<PackedStateBin> entry_data;
+    std::vector<int> entry_g;
+    // Iteration in which the entry was stored (0 for empty entries).
+    std::vector<int> entry_iteration;
+    int iteration;
+
+    long long num_hits;
+    long long num_stores;
+
+    bool is_current(size_t entry) const {
+        return entry_iteration[entry] == iteration;
+    }
+    void store(size_t entry, const PackedStateBin *data, int g);
+public:
+    TranspositionTable(int num_bins, size_t num_bytes);
+
+    void start_iteration();
+
+    /*
+      Return true if the state with the given data was visited in the
+      current iteration with a g value of at most g. Otherwise, record
+      the visit and return false.
+    */
+    bool lookup_and_store(const PackedStateBin *data, size_t hash, int g);
+
+    void print_statistics() const;
+};
+
+
+class IDAStarSearch : public SearchEngine {
+    struct PathNode {
+        std::vector<int> values;
+        std::vector<PackedStateBin> data;
+        size_t hash;
+        int g;
+        int real_g;
+    };
+
+    std::shared_ptr<Evaluator> evaluator;
+    std::unique_ptr<TranspositionTable> transposition_table;
+    std::unique_ptr<StateRegistry> scratch_registry;
+
+    int f_bound;
+    int next_f_bound;
+    int num_iterations;
+    std::vector<PathNode> path;
+    std::vector<OperatorID> path_operators;
+
+    void compute_successor(
+        const PathNode &node, const OperatorProxy &op, PathNode &succ_node);
+    bool is_on_path(const PathNode &node, int depth) const;
+    int evaluate(const PathNode &node);
+    // Search below the node at the given depth of the path.
+    bool search(int depth);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit IDAStarSearch(const options::Options &opts);
+    virtual ~IDAStarSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
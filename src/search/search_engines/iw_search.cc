@@ -0,0 +1,110 @@
+#include "iw_search.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/novelty_table.h"
+#include "../task_utils/successor_generator.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+using namespace std;
+
+namespace iw_search {
+IWSearch::IWSearch(const Options &opts)
+    : SearchEngine(opts),
+      novelty_table(utils::make_unique_ptr<novelty_table::NoveltyTable>(
+                        task_proxy, opts.get<int>("width"))),
+      num_pruned_states(0) {
+}
+
+IWSearch::~IWSearch() {
+}
+
+void IWSearch::initialize() {
+    utils::g_log << "Conducting IW(" << novelty_table->get_width()
+                 << ") search, (real) bound = " << bound << endl;
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    novelty_table->compute_novelty_and_update(initial_state.unpack().get_values());
+    SearchNode node = search_space.get_node(initial_state);
+    node.open_initial();
+    open_list.push_back(initial_state.get_id());
+}
+
+SearchStatus IWSearch::step() {
+    if (open_list.empty()) {
+        utils::g_log << "Explored all novel states -- no solution!" << endl;
+        return FAILED;
+    }
+    StateID id = open_list.front();
+    open_list.pop_front();
+    GlobalState state = state_registry.lookup_state(id);
+    SearchNode node = search_space.get_node(state);
+    node.close();
+    statistics.inc_expanded();
+
+    // Only the initial state is not checked when it is generated.
+    if (id == state_registry.get_initial_state().get_id() &&
+        check_goal_and_set_plan(state))
+        return SOLVED;
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if ((node.get_real_g() + op.get_cost()) >= bound)
+            continue;
+        GlobalState succ_state = state_registry.get_successor_state(state, op);
+        statistics.inc_generated();
+        SearchNode succ_node = search_space.get_node(succ_state);
+        if (!succ_node.is_new())
+            continue;
+
+        /*
+          We open pruned states as well, so that we do not compute their
+          novelty again when we reach them on another path.
+        */
+        succ_node.open(node, op, get_adjusted_cost(op));
+        statistics.inc_evaluated_states();
+        int novelty = novelty_table->compute_novelty_and_update(
+            succ_state.unpack().get_values());
+        if (novelty > novelty_table->get_width()) {
+            ++num_pruned_states;
+            continue;
+        }
+        if (check_goal_and_set_plan(succ_state))
+            return SOLVED;
+        open_list.push_back(succ_state.get_id());
+    }
+    return IN_PROGRESS;
+}
+
+void IWSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    search_space.print_statistics();
+    utils::g_log << "Pruned states: " << num_pruned_states << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Iterated width search IW(k)",
+        "Breadth-first search that prunes all generated states whose novelty "
+        "is larger than the width, i.e., states that do not contain a new "
+        "tuple of at most width facts. The search is incomplete and ignores "
+        "action costs for the search order.");
+    parser.add_option<int>(
+        "width",
+        "size of the largest fact tuples that are tracked",
+        "1",
+        Bounds("1", "2"));
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<IWSearch>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("iw", _parse);
+}
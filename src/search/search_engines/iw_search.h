@@ -0,0 +1,42 @@
+#ifndef SEARCH_ENGINES_IW_SEARCH_H
+#define SEARCH_ENGINES_IW_SEARCH_H
+
+#include "../search_engine.h"
+
+#include <deque>
+#include <memory>
+
+namespace novelty_table {
+class NoveltyTable;
+}
+
+namespace options {
+class Options;
+}
+
+/*
+  Iterated width search IW(k) with a single iteration: breadth-first
+  search that prunes all generated states whose novelty is larger than
+  the width k, i.e., states that contain no tuple of at most k facts
+  that was not contained in an earlier generated state. The search is
+  incomplete, but it runs in time polynomial in the number of facts.
+*/
+namespace iw_search {
+class IWSearch : public SearchEngine {
+    std::unique_ptr<novelty_table::NoveltyTable> novelty_table;
+    std::deque<StateID> open_list;
+    int num_pruned_states;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit IWSearch(const options::Options &opts);
+    virtual ~IWSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
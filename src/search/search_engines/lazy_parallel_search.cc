@@ -0,0 +1,383 @@
+#include "lazy_parallel_search.h"
+
+#include "../compressed_state_registry.h"
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../option_parser.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <set>
+
+using namespace std;
+
+namespace lazy_parallel_search {
+static bool is_same_config(const ParseTree &config1, const ParseTree &config2) {
+    if (config1.size() != config2.size()) {
+        return false;
+    }
+    ParseTree::iterator it1 = config1.begin();
+    ParseTree::iterator it2 = config2.begin();
+    for (; it1 != config1.end(); ++it1, ++it2) {
+        if (it1->value != it2->value || it1->key != it2->key ||
+            config1.depth(it1) != config2.depth(it2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+EvaluatorConfigs::EvaluatorConfigs(
+    const Options &opts, options::Registry &registry,
+    const options::Predefinitions &predefinitions)
+    : registry(registry),
+      predefinitions(predefinitions) {
+    for (const ParseTree &config : opts.get_list<ParseTree>("evals")) {
+        eval_indices.push_back(add_config(config));
+    }
+    for (const ParseTree &config : opts.get_list<ParseTree>("preferred")) {
+        preferred_indices.push_back(add_config(config));
+    }
+}
+
+int EvaluatorConfigs::add_config(const ParseTree &config) {
+    for (size_t i = 0; i < configs.size(); ++i) {
+        if (is_same_config(configs[i], config)) {
+            return i;
+        }
+    }
+    configs.push_back(config);
+    return configs.size() - 1;
+}
+
+vector<shared_ptr<Evaluator>> EvaluatorConfigs::parse() {
+    vector<shared_ptr<Evaluator>> evaluators;
+    for (const ParseTree &config : configs) {
+        OptionParser parser(config, registry, predefinitions, false);
+        evaluators.push_back(parser.start_parsing<shared_ptr<Evaluator>>());
+    }
+    return evaluators;
+}
+
+vector<shared_ptr<Evaluator>> EvaluatorConfigs::get_evals(
+    const vector<shared_ptr<Evaluator>> &evaluators) const {
+    vector<shared_ptr<Evaluator>> evals;
+    for (int index : eval_indices) {
+        evals.push_back(evaluators[index]);
+    }
+    return evals;
+}
+
+vector<shared_ptr<Evaluator>> EvaluatorConfigs::get_preferred(
+    const vector<shared_ptr<Evaluator>> &evaluators) const {
+    vector<shared_ptr<Evaluator>> preferred;
+    for (int index : preferred_indices) {
+        preferred.push_back(evaluators[index]);
+    }
+    return preferred;
+}
+
+
+static void evaluate(const vector<shared_ptr<Evaluator>> &evaluators,
+                     BatchEntry &entry) {
+    EvaluationContext eval_context(entry.state, entry.g, true, nullptr);
+    entry.results.clear();
+    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
+        entry.results.push_back(eval_context.get_result(evaluator.get()));
+    }
+}
+
+
+LazyParallelSearch::LazyParallelSearch(
+    const Options &opts, const EvaluatorConfigs &evaluator_configs,
+    const vector<shared_ptr<Evaluator>> &evaluators)
+    : LazySearch(opts),
+      evaluator_configs(evaluator_configs),
+      num_threads(opts.get<int>("num_threads") ?
+                  opts.get<int>("num_threads") :
+                  max(1U, thread::hardware_concurrency())),
+      batch_number(0),
+      batch_size(0),
+      num_busy_threads(0),
+      shutdown(false),
+      num_batches(0),
+      num_batch_entries(0) {
+    thread_evaluators.push_back(evaluators);
+}
+
+LazyParallelSearch::~LazyParallelSearch() {
+    {
+        lock_guard<mutex> lock(batch_mutex);
+        shutdown = true;
+    }
+    batch_started.notify_all();
+    for (thread &t : threads) {
+        t.join();
+    }
+}
+
+void LazyParallelSearch::initialize() {
+    utils::g_log << "Conducting K-parallel lazy best first search with K = "
+                 << num_threads << ", (real) bound = " << bound << endl;
+    LazySearch::initialize();
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "lazy_parallel does not support path-dependent evaluators."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    /*
+      Evaluators print information while they are constructed, so we parse
+      the evaluators of all threads before starting any thread.
+    */
+    for (int i = 1; i < num_threads; ++i) {
+        thread_evaluators.push_back(evaluator_configs.parse());
+        set<Evaluator *> cached_evals;
+        for (const shared_ptr<Evaluator> &evaluator : thread_evaluators.back()) {
+            cached_evals.insert(evaluator.get());
+        }
+        EvaluatorCache::assign_slots(cached_evals);
+    }
+    /*
+      Evaluators that store information per state (e.g., cached heuristic
+      values) subscribe to the state registry on their first evaluation,
+      which is not thread-safe. We therefore evaluate the initial state with
+      the evaluators of all other threads here. The main thread evaluates
+      it in the first batch.
+    */
+    batch.emplace_back(state_registry.get_initial_state(),
+                       StateID::no_state, OperatorID::no_operator, 0, 0);
+    for (int i = 1; i < num_threads; ++i) {
+        evaluate(thread_evaluators[i], batch[0]);
+    }
+    for (int i = 1; i < num_threads; ++i) {
+        threads.emplace_back(&LazyParallelSearch::run_thread, this, i);
+    }
+}
+
+void LazyParallelSearch::run_thread(int thread_id) {
+    int last_batch_number = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(batch_mutex);
+            batch_started.wait(lock, [&]() {
+                                   return shutdown || batch_number != last_batch_number;
+                               });
+            if (shutdown) {
+                return;
+            }
+            last_batch_number = batch_number;
+            if (thread_id >= batch_size) {
+                continue;
+            }
+        }
+        evaluate(thread_evaluators[thread_id], batch[thread_id]);
+        {
+            lock_guard<mutex> lock(batch_mutex);
+            --num_busy_threads;
+        }
+        batch_finished.notify_one();
+    }
+}
+
+void LazyParallelSearch::evaluate_batch() {
+    assert(!batch.empty());
+    ++num_batches;
+    num_batch_entries += batch.size();
+    if (batch.size() > 1) {
+        {
+            lock_guard<mutex> lock(batch_mutex);
+            ++batch_number;
+            batch_size = batch.size();
+            num_busy_threads = batch_size - 1;
+        }
+        batch_started.notify_all();
+    }
+    evaluate(thread_evaluators[0], batch[0]);
+    if (batch.size() > 1) {
+        unique_lock<mutex> lock(batch_mutex);
+        batch_finished.wait(lock, [&]() {return num_busy_threads == 0;});
+    }
+}
+
+SearchStatus LazyParallelSearch::fetch_next_batch() {
+    batch.clear();
+    while (static_cast<int>(batch.size()) < num_threads && !open_list->empty()) {
+        EdgeOpenListEntry next = open_list->remove_min();
+        GlobalState predecessor = state_registry.lookup_state(next.first);
+        OperatorProxy op = task_proxy.get_operators()[next.second];
+        assert(task_properties::is_applicable(op, predecessor.unpack()));
+        GlobalState state = state_registry.get_successor_state(predecessor, op);
+
+        SearchNode pred_node = search_space.get_node(predecessor);
+        int g = pred_node.get_g() + get_adjusted_cost(op);
+        int real_g = pred_node.get_real_g() + op.get_cost();
+
+        SearchNode node = search_space.get_node(state);
+        bool reopen = reopen_closed_nodes && !node.is_new() &&
+            !node.is_dead_end() && (g < node.get_g());
+        if (!node.is_new() && !reopen) {
+            continue;
+        }
+
+        /*
+          If the batch already contains the state, we keep the cheaper of
+          the two paths. lazy_greedy would reach the state by the first
+          path and possibly reopen it with the second one.
+        */
+        auto it = find_if(batch.begin(), batch.end(),
+                          [&](const BatchEntry &entry) {
+                              return entry.state.get_id() == state.get_id();
+                          });
+        if (it == batch.end()) {
+            batch.emplace_back(state, next.first, next.second, g, real_g);
+        } else if (reopen_closed_nodes && g < it->g) {
+            it->predecessor_id = next.first;
+            it->operator_id = next.second;
+            it->g = g;
+            it->real_g = real_g;
+        }
+    }
+    if (batch.empty()) {
+        utils::g_log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    return IN_PROGRESS;
+}
+
+bool LazyParallelSearch::expand(const BatchEntry &entry) {
+    /*
+      Fill the evaluator cache with the results of the threads so that the
+      open list and the preferred operator evaluators of the main thread
+      look them up instead of computing them again.
+    */
+    const vector<shared_ptr<Evaluator>> &evaluators = thread_evaluators[0];
+    EvaluatorCache cache(entry.state, &preferred_operators_pool);
+    for (size_t i = 0; i < evaluators.size(); ++i) {
+        Evaluator *evaluator = evaluators[i].get();
+        const EvaluationResult &result = entry.results[i];
+        cache[evaluator] = result;
+        if (evaluator->is_used_for_counting_evaluations() &&
+            result.get_count_evaluation()) {
+            statistics.inc_evaluations();
+        }
+    }
+
+    current_state = entry.state;
+    current_predecessor_id = entry.predecessor_id;
+    current_operator_id = entry.operator_id;
+    current_g = entry.g;
+    current_real_g = entry.real_g;
+    current_eval_context = EvaluationContext(cache, current_g, true, &statistics);
+
+    SearchNode node = search_space.get_node(current_state);
+    statistics.inc_evaluated_states();
+    if (!open_list->is_dead_end(current_eval_context)) {
+        if (current_predecessor_id == StateID::no_state) {
+            node.open_initial();
+            if (search_progress.check_progress(current_eval_context))
+                statistics.print_checkpoint_line(current_g);
+        } else {
+            GlobalState parent_state = state_registry.lookup_state(current_predecessor_id);
+            SearchNode parent_node = search_space.get_node(parent_state);
+            OperatorProxy current_operator = task_proxy.get_operators()[current_operator_id];
+            if (!node.is_new()) {
+                node.reopen(parent_node, current_operator, get_adjusted_cost(current_operator));
+                statistics.inc_reopened();
+            } else {
+                node.open(parent_node, current_operator, get_adjusted_cost(current_operator));
+            }
+        }
+        node.close();
+        if (check_goal_and_set_plan(current_state))
+            return true;
+        if (search_progress.check_progress(current_eval_context)) {
+            statistics.print_checkpoint_line(current_g);
+            reward_progress();
+        }
+        generate_successors();
+        statistics.inc_expanded();
+    } else {
+        node.mark_as_dead_end();
+        statistics.inc_dead_ends();
+    }
+    if (current_predecessor_id == StateID::no_state) {
+        print_initial_evaluator_values(current_eval_context);
+    }
+    return false;
+}
+
+SearchStatus LazyParallelSearch::step() {
+    evaluate_batch();
+    for (const BatchEntry &entry : batch) {
+        if (expand(entry)) {
+            return SOLVED;
+        }
+    }
+    return fetch_next_batch();
+}
+
+void LazyParallelSearch::print_statistics() const {
+    LazySearch::print_statistics();
+    utils::g_log << "Evaluated batches: " << num_batches << endl;
+    if (num_batches) {
+        utils::g_log << "Average batch size: "
+                     << static_cast<double>(num_batch_entries) / num_batches
+                     << endl;
+    }
+}
+
+void add_options_to_parser(OptionParser &parser) {
+    parser.add_list_option<ParseTree>("evals", "evaluators");
+    parser.add_list_option<ParseTree>(
+        "preferred",
+        "use preferred operators of these evaluators", "[]");
+    parser.add_option<bool>("reopen_closed",
+                            "reopen closed nodes", "false");
+    parser.add_option<int>(
+        "boost",
+        "boost value for alternation queues that are restricted "
+        "to preferred operator nodes",
+        "1000");
+    parser.add_option<int>(
+        "num_threads",
+        "number of states evaluated in parallel (K), using one thread per "
+        "state (0 uses one thread per hardware thread)",
+        "0",
+        Bounds("0", "infinity"));
+    SearchEngine::add_succ_order_options(parser);
+    SearchEngine::add_options_to_parser(parser);
+}
+
+static void verify_config(OptionParser &parser, const ParseTree &config) {
+    for (ParseTree::iterator it = config.begin(); it != config.end(); ++it) {
+        if (parser.get_predefinitions().contains(it->value)) {
+            parser.error(
+                "lazy_parallel parses a copy of its evaluators for each "
+                "thread and cannot use the predefined object " + it->value);
+        }
+    }
+    OptionParser test_parser(config, parser.get_registry(),
+                             parser.get_predefinitions(), true);
+    test_parser.start_parsing<shared_ptr<Evaluator>>();
+}
+
+void verify_configs(OptionParser &parser, const Options &opts) {
+    if (opts.get<StateCompression>("state_compression") != StateCompression::NONE) {
+        parser.error(
+            "lazy_parallel reads states on several threads and does not "
+            "support state_compression=tree, whose registry decompresses "
+            "states into a shared buffer");
+    }
+    for (const ParseTree &config : opts.get_list<ParseTree>("evals")) {
+        verify_config(parser, config);
+    }
+    for (const ParseTree &config : opts.get_list<ParseTree>("preferred")) {
+        verify_config(parser, config);
+    }
+}
+}
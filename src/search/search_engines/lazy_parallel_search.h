@@ -0,0 +1,155 @@
+#ifndef SEARCH_ENGINES_LAZY_PARALLEL_SEARCH_H
+#define SEARCH_ENGINES_LAZY_PARALLEL_SEARCH_H
+
+#include "lazy_search.h"
+
+#include "../evaluation_result.h"
+#include "../option_parser_util.h"
+
+#include "../options/predefinitions.h"
+#include "../options/registries.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+/*
+  K-parallel lazy greedy best-first search (KPGBFS).
+
+  The search behaves like lazy_greedy, except that it removes up to K
+  edges leading to new states from the open list at once and evaluates
+  their target states in parallel, one state per thread. The main thread
+  then expands the evaluated states in the order in which they were
+  removed: it opens and closes their search nodes, checks for goals,
+  rewards progress by boosting the preferred-operator queues and inserts
+  the successor edges into the open list. With K = 1, the search expands
+  exactly the same states as lazy_greedy.
+
+  All state registry and open list accesses happen on the main thread.
+  Evaluating a batch is synchronous: while the other threads evaluate
+  states, the main thread evaluates the first state of the batch and then
+  waits for the others, so no open list work overlaps the evaluations.
+  This way the worker threads only read from the state registry while
+  nobody writes to it. Reading a state must not modify the registry
+  either, which rules out state_compression=tree: its registry
+  decompresses states into a shared buffer.
+
+  Evaluators are not thread-safe, so each thread except the main thread
+  parses its own copy of the evaluator configurations. For this reason
+  the configurations must not refer to predefined evaluators. Identical
+  configurations in "evals" and "preferred" are parsed only once, so
+  that each thread computes every distinct evaluator once per state.
+*/
+namespace lazy_parallel_search {
+/*
+  The distinct evaluator configurations of the "evals" and "preferred"
+  options together with the positions of the evals and preferred operator
+  evaluators among them.
+*/
+class EvaluatorConfigs {
+    std::vector<options::ParseTree> configs;
+    std::vector<int> eval_indices;
+    std::vector<int> preferred_indices;
+    /*
+      We need to copy the registry and predefinitions here since they live
+      longer than the objects referenced in the constructor.
+    */
+    options::Registry registry;
+    options::Predefinitions predefinitions;
+
+    int add_config(const options::ParseTree &config);
+public:
+    EvaluatorConfigs(const options::Options &opts, options::Registry &registry,
+                     const options::Predefinitions &predefinitions);
+
+    // Parse a new copy of all distinct evaluators.
+    std::vector<std::shared_ptr<Evaluator>> parse();
+
+    std::vector<std::shared_ptr<Evaluator>> get_evals(
+        const std::vector<std::shared_ptr<Evaluator>> &evaluators) const;
+    std::vector<std::shared_ptr<Evaluator>> get_preferred(
+        const std::vector<std::shared_ptr<Evaluator>> &evaluators) const;
+};
+
+
+struct BatchEntry {
+    GlobalState state;
+    StateID predecessor_id;
+    OperatorID operator_id;
+    int g;
+    int real_g;
+    // Results of the distinct evaluators, in the order of EvaluatorConfigs.
+    std::vector<EvaluationResult> results;
+
+    BatchEntry(const GlobalState &state, StateID predecessor_id,
+               OperatorID operator_id, int g, int real_g)
+        : state(state),
+          predecessor_id(predecessor_id),
+          operator_id(operator_id),
+          g(g),
+          real_g(real_g) {
+    }
+};
+
+
+class LazyParallelSearch : public lazy_search::LazySearch {
+    EvaluatorConfigs evaluator_configs;
+    const int num_threads;
+
+    /*
+      The distinct evaluators of each thread. Thread 0 is the main thread,
+      which uses the evaluators of the open list.
+    */
+    std::vector<std::vector<std::shared_ptr<Evaluator>>> thread_evaluators;
+    std::vector<std::thread> threads;
+
+    std::vector<BatchEntry> batch;
+    std::mutex batch_mutex;
+    std::condition_variable batch_started;
+    std::condition_variable batch_finished;
+    /*
+      The following members are protected by batch_mutex. The worker
+      threads may only access the batch entry with their thread ID and only
+      while they count as busy, since the main thread changes the batch
+      between evaluations.
+    */
+    // Incremented whenever the worker threads should evaluate a new batch.
+    int batch_number;
+    int batch_size;
+    int num_busy_threads;
+    bool shutdown;
+
+    long long num_batches;
+    long long num_batch_entries;
+
+    void run_thread(int thread_id);
+    void evaluate_batch();
+    // Return true if the state of the entry is a goal state.
+    bool expand(const BatchEntry &entry);
+    SearchStatus fetch_next_batch();
+
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    LazyParallelSearch(
+        const options::Options &opts, const EvaluatorConfigs &evaluator_configs,
+        const std::vector<std::shared_ptr<Evaluator>> &evaluators);
+    virtual ~LazyParallelSearch() override;
+
+    virtual void print_statistics() const override;
+};
+
+extern void add_options_to_parser(options::OptionParser &parser);
+extern void verify_configs(options::OptionParser &parser,
+                           const options::Options &opts);
+}
+
+#endif
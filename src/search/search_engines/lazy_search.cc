@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <optional.hh>
 #include <vector>
 
 using namespace std;
@@ -30,7 +31,8 @@ LazySearch::LazySearch(const Options &opts)
       current_operator_id(OperatorID::no_operator),
       current_g(0),
       current_real_g(0),
-      current_eval_context(current_state, 0, true, &statistics) {
+      current_eval_context(current_state, 0, true, &statistics, false,
+                           &preferred_operators_pool) {
     /*
       We initialize current_eval_context in such a way that the initial node
       counts as "preferred".
@@ -56,6 +58,14 @@ void LazySearch::initialize() {
     }
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
+
+    set<Evaluator *> cached_evals;
+    open_list->get_evaluators(cached_evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        cached_evals.insert(evaluator.get());
+    }
+    EvaluatorCache::assign_slots(cached_evals);
+
     const GlobalState &initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
@@ -102,6 +112,7 @@ void LazySearch::generate_successors() {
 
     statistics.inc_generated(successor_operators.size());
 
+    int num_edges = 0;
     for (OperatorID op_id : successor_operators) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         int new_g = current_g + get_adjusted_cost(op);
@@ -111,26 +122,47 @@ void LazySearch::generate_successors() {
             EvaluationContext new_eval_context(
                 current_eval_context.get_cache(), new_g, is_preferred, nullptr);
             open_list->insert(new_eval_context, make_pair(current_state.get_id(), op_id));
+            ++num_edges;
         }
     }
+    if (num_edges > 0) {
+        /*
+          Keep the data of the state for its edges in the open list (see
+          StateRegistry::retain_state). Alternation open lists return the
+          same edge once per sublist, so we cannot tell when the last edge
+          from the state has been removed and keep it for the rest of the
+          search.
+        */
+        state_registry.retain_state(current_state.get_id());
+    }
 }
 
 SearchStatus LazySearch::fetch_next_state() {
-    if (open_list->empty()) {
-        utils::g_log << "Completely explored state space -- no solution!" << endl;
-        return FAILED;
-    }
+    tl::optional<GlobalState> current_predecessor;
+    while (true) {
+        if (open_list->empty()) {
+            utils::g_log << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
 
-    EdgeOpenListEntry next = open_list->remove_min();
+        EdgeOpenListEntry next = open_list->remove_min();
 
-    current_predecessor_id = next.first;
-    current_operator_id = next.second;
-    GlobalState current_predecessor = state_registry.lookup_state(current_predecessor_id);
+        current_predecessor_id = next.first;
+        current_operator_id = next.second;
+        current_predecessor.emplace(state_registry.lookup_state(current_predecessor_id));
+        OperatorProxy op = task_proxy.get_operators()[current_operator_id];
+        assert(task_properties::is_applicable(op, current_predecessor->unpack()));
+        // Skip the edge if the registry pruned its target state.
+        tl::optional<GlobalState> succ_state =
+            state_registry.try_get_successor_state(*current_predecessor, op);
+        if (succ_state) {
+            current_state = *succ_state;
+            break;
+        }
+    }
     OperatorProxy current_operator = task_proxy.get_operators()[current_operator_id];
-    assert(task_properties::is_applicable(current_operator, current_predecessor.unpack()));
-    current_state = state_registry.get_successor_state(current_predecessor, current_operator);
 
-    SearchNode pred_node = search_space.get_node(current_predecessor);
+    SearchNode pred_node = search_space.get_node(*current_predecessor);
     current_g = pred_node.get_g() + get_adjusted_cost(current_operator);
     current_real_g = pred_node.get_real_g() + current_operator.get_cost();
 
@@ -142,7 +174,9 @@ SearchStatus LazySearch::fetch_next_state() {
       associate with the expanded vs. evaluated nodes in lazy search
       and where to obtain it from.
     */
-    current_eval_context = EvaluationContext(current_state, current_g, true, &statistics);
+    current_eval_context = EvaluationContext(
+        current_state, current_g, true, &statistics, false,
+        &preferred_operators_pool);
 
     return IN_PROGRESS;
 }
@@ -203,6 +237,12 @@ SearchStatus LazySearch::step() {
             print_initial_evaluator_values(current_eval_context);
         }
     }
+    /*
+      Registries that recycle the data of released states never let the
+      search reopen closed nodes, so we only need the current state if edges
+      from it remain (see generate_successors).
+    */
+    state_registry.release_state(current_state.get_id());
     return fetch_next_state();
 }
 
@@ -213,5 +253,6 @@ void LazySearch::reward_progress() {
 void LazySearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    open_list->print_statistics();
 }
 }
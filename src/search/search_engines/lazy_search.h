@@ -3,6 +3,7 @@
 
 #include "../evaluation_context.h"
 #include "../evaluator.h"
+#include "../evaluator_cache.h"
 #include "../global_state.h"
 #include "../open_list.h"
 #include "../operator_id.h"
@@ -15,6 +16,7 @@
 #include <memory>
 #include <vector>
 
+
 namespace options {
 class Options;
 }
@@ -33,6 +35,9 @@ protected:
     std::vector<Evaluator *> path_dependent_evaluators;
     std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
 
+    // Must be declared before the evaluation contexts that use it.
+    PreferredOperatorsPool preferred_operators_pool;
+
     GlobalState current_state;
     StateID current_predecessor_id;
     OperatorID current_operator_id;
@@ -1,6 +1,7 @@
 #include "eager_search.h"
 #include "search_common.h"
 
+#include "../bitstate_state_registry.h"
 #include "../option_parser.h"
 #include "../plugin.h"
 
@@ -24,7 +25,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "\n```\n--search astar(evaluator)\n```\n"
         "is equivalent to\n"
         "```\n--evaluator h=evaluator\n"
-        "--search eager(tiebreaking([sum([g(), h]), h], unsafe_pruning=false),\n"
+        "--search eager(bucket_astar(sum([g(), h]), h),\n"
         "               reopen_closed=true, f_eval=sum([g(), h]))\n"
         "```\n", true);
     parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
@@ -35,6 +36,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
 
     eager_search::add_options_to_parser(parser);
     Options opts = parser.parse();
+    verify_bitstate_options(parser, opts);
 
     shared_ptr<eager_search::EagerSearch> engine;
     if (!parser.dry_run()) {
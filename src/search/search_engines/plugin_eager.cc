@@ -1,6 +1,7 @@
 #include "eager_search.h"
 #include "search_common.h"
 
+#include "../bitstate_state_registry.h"
 #include "../option_parser.h"
 #include "../plugin.h"
 
@@ -24,6 +25,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
 
     eager_search::add_options_to_parser(parser);
     Options opts = parser.parse();
+    verify_bitstate_options(parser, opts);
 
     shared_ptr<eager_search::EagerSearch> engine;
     if (!parser.dry_run()) {
@@ -0,0 +1,54 @@
+#include "hda_search.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+using namespace std;
+
+namespace plugin_hda {
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Hash-distributed best-first search",
+        "Runs a best-first search on several threads. Each thread owns a "
+        "partition of the state space, chosen by the hash value of the "
+        "packed state data, and successors are sent to the thread owning "
+        "them. Nodes whose f_eval value is not lower than the cost of the "
+        "best solution found so far are pruned, and the search continues "
+        "until all threads have run out of nodes. With an admissible f_eval "
+        "and an open list ordered by f_eval, the resulting plan is optimal. "
+        "If max_time is reached first, the search saves the best plan found "
+        "so far, but reports a timeout since the plan is not proven optimal.");
+    parser.document_note(
+        "Thread safety",
+        "Each thread parses its own copy of the open list and the evaluators, "
+        "so the configuration must not use predefined evaluators "
+        "(--evaluator h=...). Path-dependent evaluators and tasks with axioms "
+        "are not supported.");
+    parser.document_note(
+        "Memory usage",
+        "As for hda_astar, the stack and malloc arena of each thread count "
+        "against the memory limit of the driver, which limits the address "
+        "space. Setting MALLOC_ARENA_MAX=1 reduces this overhead.");
+    parser.add_option<ParseTree>("open", "open list");
+    parser.add_option<ParseTree>(
+        "f_eval",
+        "evaluator used to prune nodes that cannot lead to a cheaper solution");
+    parser.add_list_option<ParseTree>(
+        "preferred",
+        "use preferred operators of these evaluators", "[]");
+    hda_search::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.help_mode()) {
+        return nullptr;
+    } else if (parser.dry_run()) {
+        hda_search::verify_configs(parser, opts);
+        return nullptr;
+    } else {
+        return make_shared<hda_search::HDASearch>(
+            opts, parser.get_registry(), parser.get_predefinitions());
+    }
+}
+
+static Plugin<SearchEngine> _plugin("hda", _parse);
+}
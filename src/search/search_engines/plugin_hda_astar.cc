@@ -0,0 +1,60 @@
+#include "hda_search.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+using namespace std;
+
+namespace plugin_hda_astar {
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Hash-distributed A* search (HDA*)",
+        "Parallel A* in which each thread owns a partition of the state "
+        "space, chosen by the hash value of the packed state data. "
+        "Every thread uses the same open list as astar(eval). "
+        "The search terminates once no thread has a node left whose f value "
+        "is lower than the cost of the best solution found, so plans are "
+        "optimal for admissible evaluators. "
+        "If max_time is reached first, the search saves the best plan found "
+        "so far, but reports a timeout since the plan is not proven optimal.");
+    parser.document_note(
+        "Thread safety",
+        "Each thread parses its own copy of the evaluator, so the evaluator "
+        "must not be predefined (--evaluator h=...). Path-dependent "
+        "evaluators and tasks with axioms are not supported.");
+    parser.document_note(
+        "Memory usage",
+        "Every thread reserves address space for its stack and, with glibc, "
+        "for its own malloc arena (up to 64 MiB on 64-bit systems), even if "
+        "it never uses most of it. The driver limits memory by limiting the "
+        "address space, so this reservation counts against the memory "
+        "limit. For example, hda_astar(blind(), num_threads=4) uses 371 MB "
+        "of address space on a gripper task with 14 balls. Setting the "
+        "environment variable MALLOC_ARENA_MAX=1 reduces this to 164 MB, at "
+        "the cost of more contention when the threads allocate memory.");
+    parser.document_note(
+        "Equivalent statements using general HDA*",
+        "\n```\n--search hda_astar(evaluator)\n```\n"
+        "is equivalent to\n"
+        "```\n--search hda(tiebreaking([sum([g(), evaluator]), evaluator], "
+        "unsafe_pruning=false),\n"
+        "              f_eval=sum([g(), evaluator]))\n"
+        "```\n", true);
+    parser.add_option<ParseTree>("eval", "evaluator for h-value");
+    hda_search::add_options_to_parser(parser);
+    Options opts = parser.parse();
+    opts.set("preferred", vector<ParseTree>());
+
+    if (parser.help_mode()) {
+        return nullptr;
+    } else if (parser.dry_run()) {
+        hda_search::verify_configs(parser, opts);
+        return nullptr;
+    } else {
+        return make_shared<hda_search::HDASearch>(
+            opts, parser.get_registry(), parser.get_predefinitions());
+    }
+}
+
+static Plugin<SearchEngine> _plugin("hda_astar", _parse);
+}
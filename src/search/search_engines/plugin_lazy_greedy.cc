@@ -1,6 +1,7 @@
 #include "lazy_search.h"
 #include "search_common.h"
 
+#include "../bitstate_state_registry.h"
 #include "../option_parser.h"
 #include "../plugin.h"
 
@@ -59,7 +60,9 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         DEFAULT_LAZY_BOOST);
     SearchEngine::add_succ_order_options(parser);
     SearchEngine::add_options_to_parser(parser);
+    add_bitstate_options_to_parser(parser);
     Options opts = parser.parse();
+    verify_bitstate_options(parser, opts);
 
     shared_ptr<lazy_search::LazySearch> engine;
     if (!parser.dry_run()) {
@@ -0,0 +1,64 @@
+#include "lazy_parallel_search.h"
+#include "search_common.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+using namespace std;
+
+namespace plugin_lazy_parallel {
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "K-parallel greedy search (lazy)",
+        "Lazy greedy best-first search that removes up to K edges leading "
+        "to new states from the open list at once and evaluates their "
+        "target states in parallel, one state per thread (KPGBFS). "
+        "The open list, the preferred operators and the boosting of the "
+        "preferred-operator queues after progress are the same as for "
+        "lazy_greedy. With num_threads=1, the search is equivalent to "
+        "lazy_greedy with the same options. The batches are evaluated "
+        "synchronously: the search waits until all states of a batch are "
+        "evaluated before it expands them and fetches the next batch.");
+    parser.document_note(
+        "Thread safety",
+        "Each thread parses its own copy of the evaluators, so the "
+        "evaluators must not be predefined (--evaluator h=...). Instead, "
+        "identical evaluator configurations in evals and preferred are "
+        "parsed only once, so that\n"
+        "```\n--search lazy_parallel([ff()], preferred=[ff()])\n```\n"
+        "computes h^FF once per state. Path-dependent evaluators and "
+        "state_compression=tree are not supported.", true);
+    parser.document_note(
+        "Memory usage",
+        "As for hda_astar, the stack and malloc arena of each thread count "
+        "against the memory limit of the driver, which limits the address "
+        "space. For example, lazy_parallel([ff()], num_threads=4) uses "
+        "233 MB of address space on a gripper task with 14 balls, and 36 MB "
+        "with the environment variable MALLOC_ARENA_MAX=1.");
+    lazy_parallel_search::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.help_mode()) {
+        return nullptr;
+    } else if (parser.dry_run()) {
+        lazy_parallel_search::verify_configs(parser, opts);
+        return nullptr;
+    }
+
+    lazy_parallel_search::EvaluatorConfigs evaluator_configs(
+        opts, parser.get_registry(), parser.get_predefinitions());
+    vector<shared_ptr<Evaluator>> evaluators = evaluator_configs.parse();
+    vector<shared_ptr<Evaluator>> preferred_list =
+        evaluator_configs.get_preferred(evaluators);
+    opts.set("evals", evaluator_configs.get_evals(evaluators));
+    opts.set("preferred", preferred_list);
+    opts.set("open", search_common::create_greedy_open_list_factory(opts));
+    shared_ptr<lazy_parallel_search::LazyParallelSearch> engine =
+        make_shared<lazy_parallel_search::LazyParallelSearch>(
+            opts, evaluator_configs, evaluators);
+    engine->set_preferred_operator_evaluators(preferred_list);
+    return engine;
+}
+
+static Plugin<SearchEngine> _plugin("lazy_parallel", _parse);
+}
@@ -1,6 +1,7 @@
 #include "lazy_search.h"
 #include "search_common.h"
 
+#include "../bitstate_state_registry.h"
 #include "../option_parser.h"
 #include "../plugin.h"
 
@@ -66,7 +67,9 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.add_option<int>("w", "evaluator weight", "1");
     SearchEngine::add_succ_order_options(parser);
     SearchEngine::add_options_to_parser(parser);
+    add_bitstate_options_to_parser(parser);
     Options opts = parser.parse();
+    verify_bitstate_options(parser, opts);
 
     opts.verify_list_non_empty<shared_ptr<Evaluator>>("evals");
 
@@ -0,0 +1,248 @@
+#include "restarting_wastar_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <limits>
+#include <optional.hh>
+#include <set>
+
+using namespace std;
+
+namespace restarting_wastar_search {
+RestartingWAStarSearch::RestartingWAStarSearch(const Options &opts)
+    : SearchEngine(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      weights(opts.get_list<int>("weights")),
+      phase(-1),
+      phase_running(false),
+      best_plan_cost(numeric_limits<int>::max()),
+      num_reused_states(0),
+      num_phase_expansions(0) {
+}
+
+void RestartingWAStarSearch::initialize() {
+    utils::g_log << "Conducting restarting weighted A* search, (real) bound = "
+                 << bound << endl;
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "Restarting weighted A* does not support path-dependent "
+             << "evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    int h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+    SearchNode node = search_space.get_node(initial_state);
+    if (h == EvaluationResult::INFTY) {
+        utils::g_log << "Initial state is a dead end." << endl;
+        node.mark_as_dead_end();
+        statistics.inc_dead_ends();
+    } else {
+        node.open_initial();
+        node_infos[initial_state].h = h;
+    }
+}
+
+int RestartingWAStarSearch::get_priority(
+    const SearchNode &node, const RWAStarNodeInfo &info) const {
+    return node.get_g() + weights[phase] * info.h;
+}
+
+void RestartingWAStarSearch::reach_in_current_phase(
+    const SearchNode &node, RWAStarNodeInfo &info) {
+    info.phase = phase;
+    info.closed = false;
+    open_list.push(get_priority(node, info), node.get_state_id());
+}
+
+bool RestartingWAStarSearch::start_next_phase() {
+    ++phase;
+    if (phase >= static_cast<int>(weights.size())) {
+        return false;
+    }
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    SearchNode node = search_space.get_node(initial_state);
+    if (node.is_dead_end()) {
+        return false;
+    }
+    utils::g_log << "Starting phase " << phase + 1 << " with weight "
+                 << weights[phase] << " [" << statistics.get_expanded()
+                 << " expanded so far]" << endl;
+    open_list.clear();
+    reach_in_current_phase(node, node_infos[initial_state]);
+    num_phase_expansions = 0;
+    phase_running = true;
+    return true;
+}
+
+void RestartingWAStarSearch::finish_phase() {
+    utils::g_log << "Phase " << phase + 1 << " expanded "
+                 << num_phase_expansions << " state(s)" << endl;
+    phase_running = false;
+}
+
+void RestartingWAStarSearch::handle_plan(const GlobalState &goal_state) {
+    Plan plan;
+    search_space.trace_path(goal_state, plan);
+    int plan_cost = calculate_plan_cost(plan, task_proxy);
+    utils::g_log << "Solution found with cost " << plan_cost << endl;
+    if (plan_cost < best_plan_cost) {
+        best_plan_cost = plan_cost;
+        plan_manager.save_plan(plan, task_proxy, true);
+        set_plan(plan);
+        // Later phases only look for cheaper plans.
+        bound = min(bound, plan_cost);
+    }
+}
+
+SearchStatus RestartingWAStarSearch::step() {
+    if (!phase_running && !start_next_phase()) {
+        return found_solution() ? SOLVED : FAILED;
+    }
+
+    tl::optional<SearchNode> node;
+    while (true) {
+        if (open_list.empty()) {
+            finish_phase();
+            utils::g_log << "Completely explored state space -- no cheaper "
+                         << "solution!" << endl;
+            return found_solution() ? SOLVED : FAILED;
+        }
+        pair<int, StateID> entry = open_list.pop();
+        GlobalState state = state_registry.lookup_state(entry.second);
+        node.emplace(search_space.get_node(state));
+        RWAStarNodeInfo &info = node_infos[state];
+        // Skip closed nodes and entries with outdated g values.
+        if (info.closed || entry.first != get_priority(*node, info))
+            continue;
+        info.closed = true;
+        statistics.inc_expanded();
+        ++num_phase_expansions;
+        break;
+    }
+
+    GlobalState state = node->get_state();
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        handle_plan(state);
+        finish_phase();
+        return IN_PROGRESS;
+    }
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if ((node->get_real_g() + op.get_cost()) >= bound)
+            continue;
+        GlobalState succ_state = state_registry.get_successor_state(state, op);
+        statistics.inc_generated();
+        SearchNode succ_node = search_space.get_node(succ_state);
+        if (succ_node.is_dead_end())
+            continue;
+
+        RWAStarNodeInfo &succ_info = node_infos[succ_state];
+        int succ_g = node->get_g() + get_adjusted_cost(op);
+        if (succ_node.is_new()) {
+            EvaluationContext eval_context(succ_state, succ_g, false, &statistics);
+            statistics.inc_evaluated_states();
+            int h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+            if (h == EvaluationResult::INFTY) {
+                succ_node.mark_as_dead_end();
+                statistics.inc_dead_ends();
+                continue;
+            }
+            succ_node.open(*node, op, get_adjusted_cost(op));
+            succ_info.h = h;
+            reach_in_current_phase(succ_node, succ_info);
+            continue;
+        }
+
+        bool improved = succ_g < succ_node.get_g();
+        if (improved) {
+            succ_node.update_parent(*node, op, get_adjusted_cost(op));
+        }
+        if (succ_info.phase != phase) {
+            /*
+              The state was reached in an earlier phase. We reuse its h
+              value and keep its path if that path is cheaper.
+            */
+            ++num_reused_states;
+            if (succ_node.get_real_g() < bound) {
+                reach_in_current_phase(succ_node, succ_info);
+            }
+        } else if (improved) {
+            if (succ_info.closed) {
+                statistics.inc_reopened();
+            }
+            reach_in_current_phase(succ_node, succ_info);
+        }
+    }
+    return IN_PROGRESS;
+}
+
+void RestartingWAStarSearch::save_plan_if_necessary() {
+    // We don't need to save here, as we automatically save each plan.
+}
+
+void RestartingWAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    search_space.print_statistics();
+    utils::g_log << "Reused states from earlier phases: " << num_reused_states
+                 << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Restarting weighted A* (RWA*)",
+        "Anytime search that runs weighted A* once for each weight. After "
+        "each plan, the search restarts from the initial state with the "
+        "next weight and only considers cheaper plans. All phases share one "
+        "state registry, search space and the heuristic values, so states "
+        "reached in earlier phases are not evaluated again and keep the "
+        "cheapest path found for them.");
+    parser.document_note(
+        "Comparison to iterated search",
+        "The configuration\n```\n--search \"rwastar(h, weights=[5,3,2,1])\"\n```\n"
+        "is similar to\n```\n--search \"iterated([eager_wastar([h], w=5), "
+        "eager_wastar([h], w=3), eager_wastar([h], w=2), "
+        "eager_wastar([h], w=1)])\"\n```\n"
+        "but does not regenerate and reevaluate the states in each phase.");
+    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+    parser.add_list_option<int>(
+        "weights",
+        "evaluator weights of the phases",
+        "[5,3,2,1]");
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    opts.verify_list_non_empty<int>("weights");
+
+    if (parser.help_mode()) {
+        return nullptr;
+    }
+    for (int weight : opts.get_list<int>("weights")) {
+        if (weight < 1) {
+            parser.error("weights must be at least 1");
+        }
+    }
+
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<RestartingWAStarSearch>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("rwastar", _parse);
+}
@@ -0,0 +1,79 @@
+#ifndef SEARCH_ENGINES_RESTARTING_WASTAR_SEARCH_H
+#define SEARCH_ENGINES_RESTARTING_WASTAR_SEARCH_H
+
+#include "../per_state_information.h"
+#include "../search_engine.h"
+
+#include "../algorithms/priority_queues.h"
+
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace options {
+class Options;
+}
+
+/*
+  Restarting weighted A* (RWA*).
+
+  The search runs one weighted A* search for each given weight. After
+  each plan, the next phase restarts from the initial state with the next
+  weight and only considers plans that are cheaper than the best plan so
+  far. Unlike iterated(), all phases share the state registry, the search
+  space and the heuristic values. A state that was already reached in an
+  earlier phase is not evaluated again, and it keeps the cheapest path
+  found for it so far.
+*/
+namespace restarting_wastar_search {
+struct RWAStarNodeInfo {
+    // Heuristic value (only valid for states that are not new).
+    int h;
+    // Last phase in which the state was reached.
+    int phase;
+    bool closed;
+
+    RWAStarNodeInfo()
+        : h(-1),
+          phase(-1),
+          closed(false) {
+    }
+};
+
+class RestartingWAStarSearch : public SearchEngine {
+    std::shared_ptr<Evaluator> evaluator;
+    const std::vector<int> weights;
+
+    PerStateInformation<RWAStarNodeInfo> node_infos;
+    priority_queues::AdaptiveQueue<StateID> open_list;
+
+    // Index of the current phase in weights (-1 before the first phase).
+    int phase;
+    bool phase_running;
+    int best_plan_cost;
+
+    // States reached again in a later phase without evaluating them.
+    int num_reused_states;
+    int num_phase_expansions;
+
+    int get_priority(const SearchNode &node, const RWAStarNodeInfo &info) const;
+    void reach_in_current_phase(const SearchNode &node, RWAStarNodeInfo &info);
+    bool start_next_phase();
+    void finish_phase();
+    void handle_plan(const GlobalState &goal_state);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit RestartingWAStarSearch(const options::Options &opts);
+    virtual ~RestartingWAStarSearch() override = default;
+
+    virtual void save_plan_if_necessary() override;
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -9,7 +9,7 @@
 
 #include "../open_lists/alternation_open_list.h"
 #include "../open_lists/best_first_open_list.h"
-#include "../open_lists/tiebreaking_open_list.h"
+#include "../open_lists/bucket_astar_open_list.h"
 
 #include <memory>
 
@@ -115,14 +115,13 @@ create_astar_open_list_factory_and_f_eval(const Options &opts) {
     shared_ptr<GEval> g = make_shared<GEval>();
     shared_ptr<Evaluator> h = opts.get<shared_ptr<Evaluator>>("eval");
     shared_ptr<Evaluator> f = make_shared<SumEval>(vector<shared_ptr<Evaluator>>({g, h}));
-    vector<shared_ptr<Evaluator>> evals = {f, h};
 
     Options options;
-    options.set("evals", evals);
+    options.set("f", f);
+    options.set("h", h);
     options.set("pref_only", false);
-    options.set("unsafe_pruning", false);
     shared_ptr<OpenListFactory> open =
-        make_shared<tiebreaking_open_list::TieBreakingOpenListFactory>(options);
+        make_shared<bucket_astar_open_list::BucketAStarOpenListFactory>(options);
     return make_pair(open, f);
 }
 }
@@ -71,9 +71,10 @@ extern std::shared_ptr<OpenListFactory> create_wastar_open_list_factory(
   Create open list factory and f_evaluator (used for displaying progress
   statistics) for A* search.
 
-  The resulting open list factory produces a tie-breaking open list
-  ordered primarily on g + h and secondarily on h. Uses "eval" from
-  the passed-in Options object as the h evaluator.
+  The resulting open list factory produces a bucket-based open list
+  ordered primarily on g + h and secondarily on h (see
+  bucket_astar_open_list.h). Uses "eval" from the passed-in Options
+  object as the h evaluator.
 */
 extern std::pair<std::shared_ptr<OpenListFactory>, const std::shared_ptr<Evaluator>>
 create_astar_open_list_factory_and_f_eval(const options::Options &opts);
@@ -1,10 +1,44 @@
 #include "search_node_info.h"
 
-static const int pointer_bytes = sizeof(void *);
-static const int info_bytes = 3 * sizeof(int) + sizeof(StateID);
-static const int padding_bytes = info_bytes % pointer_bytes;
-
-static_assert(
-    sizeof(SearchNodeInfo) == info_bytes + padding_bytes,
-    "The size of SearchNodeInfo is larger than expected. This probably means "
-    "that packing two fields into one integer using bitfields is not supported.");
+#include <algorithm>
+
+using namespace std;
+
+const int SearchNodeInfoLayout::STATUS_BITS;
+const uint32_t SearchNodeInfoLayout::STATUS_MASK;
+const int SearchNodeInfoLayout::MAX_G;
+const int SearchNodeInfoLayout::STATUS_AND_G_OFFSET;
+const int SearchNodeInfoLayout::PARENT_OFFSET;
+const int SearchNodeInfoLayout::OPERATOR_OFFSET;
+
+SearchNodeInfoLayout::SearchNodeInfoLayout(
+    int num_operators, bool store_parents, bool store_real_g)
+    : store_parents(store_parents),
+      operator_bytes(0),
+      store_real_g(store_real_g) {
+    if (store_parents) {
+        // We store operator IDs + 1, so that OperatorID::no_operator becomes 0.
+        operator_bytes = 1;
+        while (operator_bytes < 4 &&
+               static_cast<uint32_t>(num_operators) >= (1u << (8 * operator_bytes))) {
+            ++operator_bytes;
+        }
+        real_g_offset = OPERATOR_OFFSET + operator_bytes;
+    } else {
+        real_g_offset = PARENT_OFFSET;
+    }
+    num_bytes = real_g_offset + (store_real_g ? sizeof(int) : 0);
+}
+
+int SearchNodeInfoLayout::get_unpacked_num_bytes() {
+    // Status and g, parent state ID, creating operator and real g.
+    int unpacked_bytes = 3 * sizeof(int) + sizeof(StateID);
+    int alignment = max(alignof(int), alignof(StateID));
+    return (unpacked_bytes + alignment - 1) / alignment * alignment;
+}
+
+vector<uint8_t> SearchNodeInfoLayout::get_default_info() const {
+    vector<uint8_t> info(num_bytes, 0);
+    set_real_g(info.data(), -1);
+    return info;
+}
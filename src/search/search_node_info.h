@@ -4,21 +4,151 @@
 #include "operator_id.h"
 #include "state_id.h"
 
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
-struct SearchNodeInfo {
+/*
+  A search node info is the part of a search node besides the state that
+  needs to be stored: its status, g value, parent state, creating operator
+  and real g value (i.e., the g value with the real operator costs). We
+  store it as an array of bytes whose layout is chosen when the search
+  starts, so that we only pay for the information the search needs:
+
+    - bytes 0-3 hold the status (2 bits) and g + 1 (30 bits),
+    - the next sizeof(StateID) bytes hold the parent state ID + 1,
+    - the next 1-4 bytes hold the creating operator ID + 1, using only as
+      many bytes as the number of operators requires,
+    - the last 4 bytes hold the real g value. We only store them if the
+      search uses adjusted operator costs that differ from the real costs;
+      otherwise, the real g value is the g value.
+
+  Searches can also drop the parent state and creating operator. Then
+  the search space reconstructs plans from the g values alone (see
+  SearchSpace::trace_path).
+
+  An info with all bytes zero (and a real g value of -1) is a new node.
+*/
+class SearchNodeInfoLayout {
+public:
     enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
+private:
+    static const int STATUS_BITS = 2;
+    static const uint32_t STATUS_MASK = (1u << STATUS_BITS) - 1;
+    static const int MAX_G = (1 << (32 - STATUS_BITS)) - 2;
+
+    static const int STATUS_AND_G_OFFSET = 0;
+    static const int PARENT_OFFSET = sizeof(uint32_t);
+    static const int OPERATOR_OFFSET = PARENT_OFFSET + sizeof(StateID::value_type);
+
+    bool store_parents;
+    int operator_bytes;
+    bool store_real_g;
+    int real_g_offset;
+    int num_bytes;
+
+    uint32_t get_status_and_g(const uint8_t *info) const {
+        uint32_t status_and_g;
+        std::memcpy(&status_and_g, info + STATUS_AND_G_OFFSET, sizeof(uint32_t));
+        return status_and_g;
+    }
+
+    void set_status_and_g(uint8_t *info, uint32_t status_and_g) const {
+        std::memcpy(info + STATUS_AND_G_OFFSET, &status_and_g, sizeof(uint32_t));
+    }
+public:
+    SearchNodeInfoLayout(
+        int num_operators, bool store_parents, bool store_real_g);
+
+    // Number of bytes per search node info.
+    int get_num_bytes() const {
+        return num_bytes;
+    }
+
+    // Number of bytes of the unpacked struct we used before.
+    static int get_unpacked_num_bytes();
+
+    bool stores_parents() const {
+        return store_parents;
+    }
+
+    bool stores_real_g() const {
+        return store_real_g;
+    }
+
+    // The info of a new node.
+    std::vector<uint8_t> get_default_info() const;
 
-    unsigned int status : 2;
-    int g : 30;
-    StateID parent_state_id;
-    OperatorID creating_operator;
-    int real_g;
+    NodeStatus get_status(const uint8_t *info) const {
+        return static_cast<NodeStatus>(get_status_and_g(info) & STATUS_MASK);
+    }
+
+    void set_status(uint8_t *info, NodeStatus status) const {
+        set_status_and_g(
+            info, (get_status_and_g(info) & ~STATUS_MASK) | status);
+    }
+
+    int get_g(const uint8_t *info) const {
+        return static_cast<int>(get_status_and_g(info) >> STATUS_BITS) - 1;
+    }
+
+    void set_g(uint8_t *info, int g) const {
+        assert(g >= -1 && g <= MAX_G);
+        set_status_and_g(
+            info, (static_cast<uint32_t>(g + 1) << STATUS_BITS) |
+            (get_status_and_g(info) & STATUS_MASK));
+    }
+
+    int get_real_g(const uint8_t *info) const {
+        if (!store_real_g) {
+            return get_g(info);
+        }
+        int real_g;
+        std::memcpy(&real_g, info + real_g_offset, sizeof(int));
+        return real_g;
+    }
+
+    void set_real_g(uint8_t *info, int real_g) const {
+        if (store_real_g) {
+            std::memcpy(info + real_g_offset, &real_g, sizeof(int));
+        } else {
+            assert(real_g == get_g(info));
+        }
+    }
+
+    StateID get_parent_state_id(const uint8_t *info) const {
+        assert(store_parents);
+        StateID::value_type value;
+        std::memcpy(&value, info + PARENT_OFFSET, sizeof(value));
+        return StateID(value - 1);
+    }
+
+    void set_parent_state_id(uint8_t *info, StateID id) const {
+        if (!store_parents) {
+            return;
+        }
+        StateID::value_type value = id.value + 1;
+        std::memcpy(info + PARENT_OFFSET, &value, sizeof(value));
+    }
+
+    OperatorID get_creating_operator(const uint8_t *info) const {
+        assert(store_parents);
+        uint32_t value = 0;
+        for (int i = 0; i < operator_bytes; ++i) {
+            value |= static_cast<uint32_t>(info[OPERATOR_OFFSET + i]) << (8 * i);
+        }
+        return OperatorID(static_cast<int>(value) - 1);
+    }
 
-    SearchNodeInfo()
-        : status(NEW), g(-1), parent_state_id(StateID::no_state),
-          creating_operator(-1), real_g(-1) {
+    void set_creating_operator(uint8_t *info, OperatorID op_id) const {
+        uint32_t value = op_id.get_index() + 1;
+        for (int i = 0; i < operator_bytes; ++i) {
+            info[OPERATOR_OFFSET + i] = static_cast<uint8_t>(value >> (8 * i));
+        }
     }
 };
 
@@ -4,17 +4,24 @@
 #include "search_node_info.h"
 #include "task_proxy.h"
 
+#include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/system.h"
+#include "utils/timer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iostream>
 
 using namespace std;
 
 SearchNode::SearchNode(const StateRegistry &state_registry,
                        StateID state_id,
-                       SearchNodeInfo &info)
+                       const SearchNodeInfoLayout &layout,
+                       uint8_t *info)
     : state_registry(state_registry),
       state_id(state_id),
+      layout(layout),
       info(info) {
     assert(state_id != StateID::no_state);
 }
@@ -24,139 +31,411 @@ GlobalState SearchNode::get_state() const {
 }
 
 bool SearchNode::is_open() const {
-    return info.status == SearchNodeInfo::OPEN;
+    return layout.get_status(info) == SearchNodeInfoLayout::OPEN;
 }
 
 bool SearchNode::is_closed() const {
-    return info.status == SearchNodeInfo::CLOSED;
+    return layout.get_status(info) == SearchNodeInfoLayout::CLOSED;
 }
 
 bool SearchNode::is_dead_end() const {
-    return info.status == SearchNodeInfo::DEAD_END;
+    return layout.get_status(info) == SearchNodeInfoLayout::DEAD_END;
 }
 
 bool SearchNode::is_new() const {
-    return info.status == SearchNodeInfo::NEW;
+    return layout.get_status(info) == SearchNodeInfoLayout::NEW;
 }
 
 int SearchNode::get_g() const {
-    assert(info.g >= 0);
-    return info.g;
+    assert(layout.get_g(info) >= 0);
+    return layout.get_g(info);
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    return layout.get_real_g(info);
 }
 
 void SearchNode::open_initial() {
-    assert(info.status == SearchNodeInfo::NEW);
-    info.status = SearchNodeInfo::OPEN;
-    info.g = 0;
-    info.real_g = 0;
-    info.parent_state_id = StateID::no_state;
-    info.creating_operator = OperatorID::no_operator;
+    assert(layout.get_status(info) == SearchNodeInfoLayout::NEW);
+    layout.set_status(info, SearchNodeInfoLayout::OPEN);
+    layout.set_g(info, 0);
+    layout.set_real_g(info, 0);
+    layout.set_parent_state_id(info, StateID::no_state);
+    layout.set_creating_operator(info, OperatorID::no_operator);
 }
 
 void SearchNode::open(const SearchNode &parent_node,
                       const OperatorProxy &parent_op,
                       int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::NEW);
-    info.status = SearchNodeInfo::OPEN;
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    assert(layout.get_status(info) == SearchNodeInfoLayout::NEW);
+    layout.set_status(info, SearchNodeInfoLayout::OPEN);
+    update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::reopen(const SearchNode &parent_node,
                         const OperatorProxy &parent_op,
                         int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::OPEN ||
-           info.status == SearchNodeInfo::CLOSED);
+    assert(layout.get_status(info) == SearchNodeInfoLayout::OPEN ||
+           layout.get_status(info) == SearchNodeInfoLayout::CLOSED);
 
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
-    info.status = SearchNodeInfo::OPEN;
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    layout.set_status(info, SearchNodeInfoLayout::OPEN);
+    update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 // like reopen, except doesn't change status
 void SearchNode::update_parent(const SearchNode &parent_node,
                                const OperatorProxy &parent_op,
                                int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::OPEN ||
-           info.status == SearchNodeInfo::CLOSED);
+    assert(layout.get_status(info) == SearchNodeInfoLayout::OPEN ||
+           layout.get_status(info) == SearchNodeInfoLayout::CLOSED);
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    layout.set_g(info, parent_node.get_g() + adjusted_cost);
+    layout.set_real_g(info, parent_node.get_real_g() + parent_op.get_cost());
+    layout.set_parent_state_id(info, parent_node.get_state_id());
+    layout.set_creating_operator(info, OperatorID(parent_op.get_id()));
 }
 
 void SearchNode::close() {
-    assert(info.status == SearchNodeInfo::OPEN);
-    info.status = SearchNodeInfo::CLOSED;
+    assert(layout.get_status(info) == SearchNodeInfoLayout::OPEN);
+    layout.set_status(info, SearchNodeInfoLayout::CLOSED);
 }
 
 void SearchNode::mark_as_dead_end() {
-    info.status = SearchNodeInfo::DEAD_END;
+    layout.set_status(info, SearchNodeInfoLayout::DEAD_END);
 }
 
 void SearchNode::dump(const TaskProxy &task_proxy) const {
     utils::g_log << state_id << ": ";
     get_state().dump_fdr();
-    if (info.creating_operator != OperatorID::no_operator) {
+    if (!layout.stores_parents()) {
+        utils::g_log << " no parent information" << endl;
+        return;
+    }
+    OperatorID creating_operator = layout.get_creating_operator(info);
+    if (creating_operator != OperatorID::no_operator) {
         OperatorsProxy operators = task_proxy.get_operators();
-        OperatorProxy op = operators[info.creating_operator.get_index()];
+        OperatorProxy op = operators[creating_operator.get_index()];
         utils::g_log << " created by " << op.get_name()
-                     << " from " << info.parent_state_id << endl;
+                     << " from " << layout.get_parent_state_id(info) << endl;
     } else {
         utils::g_log << " no parent" << endl;
     }
 }
 
-SearchSpace::SearchSpace(StateRegistry &state_registry)
-    : state_registry(state_registry) {
+static bool adjusted_costs_differ_from_real_costs(
+    const TaskProxy &task_proxy, OperatorCost cost_type, bool is_unit_cost) {
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (get_adjusted_action_cost(op, cost_type, is_unit_cost) != op.get_cost()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+  Without parent pointers, trace_path_by_regression() looks up every
+  combination of values of the variables that an operator changes without
+  a precondition on them. We bound the number of these candidate
+  predecessors per operator, so that reconstructing a plan takes at most
+  plan length * number of operators * MAX_REGRESSION_CANDIDATES registry
+  lookups. The limit admits operators with one or two free variables of
+  moderate domain size, which covers the usual STRIPS translations.
+*/
+static const int MAX_REGRESSION_CANDIDATES = 1024;
+
+static int get_num_regression_candidates(
+    const VariablesProxy &variables, const OperatorProxy &op) {
+    vector<bool> has_precondition(variables.size(), false);
+    for (FactProxy precondition : op.get_preconditions()) {
+        has_precondition[precondition.get_variable().get_id()] = true;
+    }
+    int num_candidates = 1;
+    for (EffectProxy effect : op.get_effects()) {
+        int var = effect.get_fact().get_variable().get_id();
+        if (!has_precondition[var]) {
+            // Count each variable once.
+            has_precondition[var] = true;
+            num_candidates *= variables[var].get_domain_size();
+            if (num_candidates > MAX_REGRESSION_CANDIDATES) {
+                break;
+            }
+        }
+    }
+    return num_candidates;
+}
+
+static void verify_regression_is_bounded(const TaskProxy &task_proxy) {
+    if (task_properties::has_conditional_effects(task_proxy)) {
+        cerr << "store_parents=false does not support conditional effects."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    VariablesProxy variables = task_proxy.get_variables();
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (get_num_regression_candidates(variables, op) >
+            MAX_REGRESSION_CANDIDATES) {
+            cerr << "store_parents=false does not support operator "
+                 << op.get_name() << ": it changes variables without "
+                 << "preconditions on them with more than "
+                 << MAX_REGRESSION_CANDIDATES << " combined values." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+    }
+}
+
+SearchSpace::SearchSpace(
+    StateRegistry &state_registry,
+    OperatorCost cost_type,
+    bool store_parents,
+    const shared_ptr<mapped_file_arena::MappedFileArena> &arena)
+    : cost_type(cost_type),
+      is_unit_cost(task_properties::is_unit_cost(state_registry.get_task_proxy())),
+      layout(state_registry.get_task_proxy().get_operators().size(),
+             store_parents,
+             adjusted_costs_differ_from_real_costs(
+                 state_registry.get_task_proxy(), cost_type, is_unit_cost)),
+      search_node_infos(layout.get_default_info(), arena),
+      state_registry(state_registry) {
+    if (!store_parents) {
+        verify_regression_is_bounded(state_registry.get_task_proxy());
+    }
 }
 
 SearchNode SearchSpace::get_node(const GlobalState &state) {
-    return SearchNode(state_registry, state.get_id(), search_node_infos[state]);
+    return SearchNode(
+        state_registry, state.get_id(), layout, &search_node_infos[state][0]);
 }
 
 void SearchSpace::trace_path(const GlobalState &goal_state,
                              vector<OperatorID> &path) const {
-    GlobalState current_state = goal_state;
+    if (!layout.stores_parents()) {
+        trace_path_by_regression(goal_state, path);
+        return;
+    }
+    // We only follow state IDs, so the registry need not keep the state data.
+    StateID current_id = goal_state.get_id();
     assert(path.empty());
     for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
-        if (info.creating_operator == OperatorID::no_operator) {
-            assert(info.parent_state_id == StateID::no_state);
+        const uint8_t *info = &search_node_infos.get(state_registry, current_id)[0];
+        OperatorID creating_operator = layout.get_creating_operator(info);
+        if (creating_operator == OperatorID::no_operator) {
+            assert(layout.get_parent_state_id(info) == StateID::no_state);
             break;
         }
-        path.push_back(info.creating_operator);
-        current_state = state_registry.lookup_state(info.parent_state_id);
+        path.push_back(creating_operator);
+        current_id = layout.get_parent_state_id(info);
     }
     reverse(path.begin(), path.end());
 }
 
+namespace {
+/*
+  Operator data used by trace_path_by_regression(), computed once per plan
+  reconstruction instead of once per operator and plan step.
+*/
+struct RegressionOperator {
+    OperatorID id;
+    int cost;
+    // All effects, which must hold in the regressed state.
+    vector<FactPair> effects;
+    // Preconditions on variables that the operator does not change.
+    vector<FactPair> prevail_conditions;
+    // Preconditions on variables that the operator changes.
+    vector<FactPair> changed_conditions;
+    // Changed variables without precondition, in increasing order.
+    vector<int> free_vars;
+
+    RegressionOperator(OperatorID id, int cost)
+        : id(id), cost(cost) {
+    }
+};
+}
+
+/*
+  Without parent pointers, we reconstruct the path backwards from the g
+  values. Every reached state except the initial state has a reached
+  predecessor p and an operator o with g(p) + cost(o) <= g(state): equality
+  holds when the g value of the state is set, and g values only decrease
+  afterwards. For each operator, we regress the state to obtain the
+  candidate predecessors (enumerating the variables that the operator
+  changes without a precondition on them) and look them up in the
+  registry. The constructor ensures that there are at most
+  MAX_REGRESSION_CANDIDATES such candidates per operator. We move to the
+  candidate with the lowest g value, so the path costs at most the g value
+  of the goal state.
+
+  Only operators whose effects hold in a state can lead to it, so we index
+  every operator by one of its effect facts and only regress through the
+  operators indexed by facts of the current state. Operators without
+  effects only lead to their own predecessor, so we never need them.
+*/
+void SearchSpace::trace_path_by_regression(
+    const GlobalState &goal_state, vector<OperatorID> &path) const {
+    assert(path.empty());
+    utils::Timer timer;
+    const TaskProxy &task_proxy = state_registry.get_task_proxy();
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    int num_bins = state_registry.get_bins_per_state();
+    StateID initial_state_id = state_registry.get_initial_state().get_id();
+
+    vector<RegressionOperator> operators;
+    // operators_by_fact[var][value]: indices into operators.
+    vector<vector<vector<int>>> operators_by_fact(num_variables);
+    for (VariableProxy var : variables) {
+        operators_by_fact[var.get_id()].resize(var.get_domain_size());
+    }
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        EffectsProxy effects = op.get_effects();
+        if (effects.size() == 0) {
+            continue;
+        }
+        RegressionOperator regression_op(
+            OperatorID(op.get_id()),
+            get_adjusted_action_cost(op, cost_type, is_unit_cost));
+        for (EffectProxy effect : effects) {
+            FactPair fact = effect.get_fact().get_pair();
+            regression_op.effects.push_back(fact);
+            regression_op.free_vars.push_back(fact.var);
+        }
+        vector<int> &free_vars = regression_op.free_vars;
+        sort(free_vars.begin(), free_vars.end());
+        free_vars.erase(unique(free_vars.begin(), free_vars.end()), free_vars.end());
+        for (FactProxy precondition : op.get_preconditions()) {
+            FactPair fact = precondition.get_pair();
+            auto it = lower_bound(free_vars.begin(), free_vars.end(), fact.var);
+            if (it != free_vars.end() && *it == fact.var) {
+                regression_op.changed_conditions.push_back(fact);
+                free_vars.erase(it);
+            } else if (!variables[fact.var].is_derived()) {
+                regression_op.prevail_conditions.push_back(fact);
+            }
+        }
+        FactPair anchor = regression_op.effects.front();
+        operators_by_fact[anchor.var][anchor.value].push_back(operators.size());
+        operators.push_back(move(regression_op));
+    }
+
+    vector<PackedStateBin> state_data(num_bins);
+    vector<PackedStateBin> predecessor_data(num_bins);
+    vector<PackedStateBin> successor_data(num_bins);
+    vector<int> values(num_variables);
+    vector<int> predecessor_values(num_variables);
+    // States on the path so far, to avoid cycles of zero-cost operators.
+    vector<StateID> path_states;
+    auto holds = [&values](const FactPair &fact) {
+            return values[fact.var] == fact.value;
+        };
+
+    GlobalState current_state = goal_state;
+    while (current_state.get_id() != initial_state_id) {
+        path_states.push_back(current_state.get_id());
+        int g = layout.get_g(&search_node_infos[current_state][0]);
+        assert(g >= 0);
+        state_registry.copy_state_data(current_state, state_data.data());
+        state_registry.unpack_state_data(state_data.data(), values.data());
+
+        StateID best_predecessor = StateID::no_state;
+        OperatorID best_operator = OperatorID::no_operator;
+        int best_g = g + 1;
+        for (int var = 0; var < num_variables; ++var) {
+            for (int op_index : operators_by_fact[var][values[var]]) {
+                const RegressionOperator &op = operators[op_index];
+                if (op.cost > g) {
+                    continue;
+                }
+                /*
+                  Regress the state: changed variables take the value of
+                  their precondition or any value, and all other variables
+                  keep their values.
+                */
+                if (!all_of(op.effects.begin(), op.effects.end(), holds) ||
+                    !all_of(op.prevail_conditions.begin(),
+                            op.prevail_conditions.end(), holds)) {
+                    continue;
+                }
+                predecessor_values = values;
+                for (const FactPair &fact : op.changed_conditions) {
+                    predecessor_values[fact.var] = fact.value;
+                }
+                for (int free_var : op.free_vars) {
+                    predecessor_values[free_var] = 0;
+                }
+                OperatorProxy op_proxy = task_proxy.get_operators()[op.id];
+
+                // Enumerate all values of the free variables.
+                while (true) {
+                    state_registry.pack_state_data(
+                        predecessor_values, predecessor_data.data());
+                    StateID id = state_registry.find_state(predecessor_data.data());
+                    if (id != StateID::no_state &&
+                        find(path_states.begin(), path_states.end(), id) == path_states.end()) {
+                        GlobalState predecessor = state_registry.lookup_state(id);
+                        const uint8_t *info = &search_node_infos[predecessor][0];
+                        int predecessor_g = layout.get_g(info);
+                        if (layout.get_status(info) != SearchNodeInfoLayout::NEW &&
+                            predecessor_g >= 0 && predecessor_g + op.cost <= g &&
+                            predecessor_g < best_g &&
+                            task_properties::is_applicable(op_proxy, predecessor.unpack())) {
+                            state_registry.compute_successor_data(
+                                predecessor, op_proxy, successor_data.data());
+                            if (successor_data == state_data) {
+                                best_predecessor = id;
+                                best_operator = op.id;
+                                best_g = predecessor_g;
+                            }
+                        }
+                    }
+                    size_t i = 0;
+                    for (; i < op.free_vars.size(); ++i) {
+                        int free_var = op.free_vars[i];
+                        if (++predecessor_values[free_var] <
+                            variables[free_var].get_domain_size()) {
+                            break;
+                        }
+                        predecessor_values[free_var] = 0;
+                    }
+                    if (i == op.free_vars.size()) {
+                        break;
+                    }
+                }
+            }
+        }
+        if (best_predecessor == StateID::no_state) {
+            cerr << "Could not reconstruct the plan from the g values." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        path.push_back(best_operator);
+        current_state = state_registry.lookup_state(best_predecessor);
+    }
+    reverse(path.begin(), path.end());
+    utils::g_log << "Time for reconstructing the plan from g values: "
+                 << timer << endl;
+}
+
 void SearchSpace::dump(const TaskProxy &task_proxy) const {
     OperatorsProxy operators = task_proxy.get_operators();
     for (StateID id : state_registry) {
         /* The body duplicates SearchNode::dump() but we cannot create
            a search node without discarding the const qualifier. */
         GlobalState state = state_registry.lookup_state(id);
-        const SearchNodeInfo &node_info = search_node_infos[state];
+        const uint8_t *node_info = &search_node_infos[state][0];
         utils::g_log << id << ": ";
         state.dump_fdr();
-        if (node_info.creating_operator != OperatorID::no_operator &&
-            node_info.parent_state_id != StateID::no_state) {
-            OperatorProxy op = operators[node_info.creating_operator.get_index()];
+        if (!layout.stores_parents()) {
+            utils::g_log << "has no parent information" << endl;
+            continue;
+        }
+        OperatorID creating_operator = layout.get_creating_operator(node_info);
+        StateID parent_state_id = layout.get_parent_state_id(node_info);
+        if (creating_operator != OperatorID::no_operator &&
+            parent_state_id != StateID::no_state) {
+            OperatorProxy op = operators[creating_operator.get_index()];
             utils::g_log << " created by " << op.get_name()
-                         << " from " << node_info.parent_state_id << endl;
+                         << " from " << parent_state_id << endl;
         } else {
             utils::g_log << "has no parent" << endl;
         }
@@ -165,4 +444,16 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
 
 void SearchSpace::print_statistics() const {
     state_registry.print_statistics();
+    int unpacked_bytes = SearchNodeInfoLayout::get_unpacked_num_bytes();
+    utils::g_log << "Search node info bytes per state: "
+                 << layout.get_num_bytes() << " (unpacked: " << unpacked_bytes
+                 << ", parents "
+                 << (layout.stores_parents() ? "stored" : "not stored")
+                 << ", real g values "
+                 << (layout.stores_real_g() ? "stored" : "not stored") << ")"
+                 << endl;
+    size_t saved_bytes = state_registry.size() *
+        (unpacked_bytes - layout.get_num_bytes());
+    utils::g_log << "Memory saved by packing search node infos: "
+                 << saved_bytes / 1024 << " KB" << endl;
 }
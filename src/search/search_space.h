@@ -3,9 +3,10 @@
 
 #include "global_state.h"
 #include "operator_cost.h"
-#include "per_state_information.h"
+#include "per_state_array.h"
 #include "search_node_info.h"
 
+#include <memory>
 #include <vector>
 
 class GlobalState;
@@ -16,11 +17,13 @@ class TaskProxy;
 class SearchNode {
     const StateRegistry &state_registry;
     StateID state_id;
-    SearchNodeInfo &info;
+    const SearchNodeInfoLayout &layout;
+    uint8_t *info;
 public:
     SearchNode(const StateRegistry &state_registry,
                StateID state_id,
-               SearchNodeInfo &info);
+               const SearchNodeInfoLayout &layout,
+               uint8_t *info);
 
     StateID get_state_id() const {
         return state_id;
@@ -53,11 +56,28 @@ public:
 
 
 class SearchSpace {
-    PerStateInformation<SearchNodeInfo> search_node_infos;
+    const OperatorCost cost_type;
+    const bool is_unit_cost;
+    const SearchNodeInfoLayout layout;
+    PerStateArray<uint8_t> search_node_infos;
 
     StateRegistry &state_registry;
+
+    void trace_path_by_regression(
+        const GlobalState &goal_state, std::vector<OperatorID> &path) const;
 public:
-    explicit SearchSpace(StateRegistry &state_registry);
+    /*
+      The search node infos only store real g values if the adjusted
+      costs of cost_type differ from the real costs for some operator.
+      Without store_parents, they do not store parent states and creating
+      operators, and trace_path() reconstructs paths from the g values. If
+      arena is given, the search node infos are stored in its file.
+    */
+    SearchSpace(
+        StateRegistry &state_registry,
+        OperatorCost cost_type,
+        bool store_parents = true,
+        const std::shared_ptr<mapped_file_arena::MappedFileArena> &arena = nullptr);
 
     SearchNode get_node(const GlobalState &state);
     void trace_path(const GlobalState &goal_state,
@@ -1,31 +1,49 @@
 #ifndef STATE_ID_H
 #define STATE_ID_H
 
+#include <cstdint>
 #include <iostream>
 
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
 class StateID {
+    friend class BitstateStateRegistry;
+    friend class CompressedStateRegistry;
+    friend class ConcurrentStateRegistry;
     friend class StateRegistry;
+    friend class StateRegistryBase;
     friend std::ostream &operator<<(std::ostream &os, StateID id);
     template<typename>
+    friend class ConcurrentPerStateInformation;
+    template<typename>
     friend class PerStateInformation;
     template<typename>
     friend class PerStateArray;
     friend class PerStateBitset;
+    friend class SearchNodeInfoLayout;
 
-    int value;
-    explicit StateID(int value_)
+public:
+    /*
+      By default, state IDs are 32-bit integers, which limits the number of
+      states in a registry to 2^31 - 1. Configure the build with
+      USE_64_BIT_STATE_IDS to lift this limit at the cost of more memory for
+      everything that stores state IDs.
+    */
+#ifdef USE_64_BIT_STATE_IDS
+    using value_type = int64_t;
+#else
+    using value_type = int;
+#endif
+private:
+    value_type value;
+    explicit StateID(value_type value_)
         : value(value_) {
     }
 
     // No implementation to prevent default construction
     StateID();
 public:
-    ~StateID() {
-    }
-
     static const StateID no_state;
 
     bool operator==(const StateID &other) const {
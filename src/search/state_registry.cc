@@ -1,66 +1,209 @@
 #include "state_registry.h"
 
+#include "option_parser.h"
 #include "per_state_information.h"
 #include "task_proxy.h"
 
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/system.h"
+
+#include <algorithm>
+#include <iostream>
 
 using namespace std;
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+const StateID::value_type StateRegistry::SCRATCH_ID;
+const int StateRegistry::HASH_BINS;
+
+StateRegistryBase::StateRegistryBase(
+    const TaskProxy &task_proxy, bool has_compressed_states)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
-      state_data_pool(get_bins_per_state()),
+      num_states(0),
+      has_compressed_states(has_compressed_states) {
+}
+
+const PackedStateBin *StateRegistryBase::decompress_state_data(StateID) const {
+    ABORT("decompress_state_data() is only used by registries with "
+          "compressed states");
+}
+
+void StateRegistryBase::pack_initial_state(PackedStateBin *buffer) const {
+    // Avoid garbage values in half-full bins.
+    fill_n(buffer, get_bins_per_state(), 0);
+
+    State initial_state = task_proxy.get_initial_state();
+    for (size_t i = 0; i < initial_state.size(); ++i) {
+        state_packer.set(buffer, i, initial_state[i].get_value());
+    }
+}
+
+void StateRegistryBase::write_successor_data(
+    const GlobalState &predecessor, const OperatorProxy &op,
+    PackedStateBin *buffer) const {
+    assert(!op.is_axiom());
+    const PackedStateBin *predecessor_data = get_state_data(predecessor);
+    copy(predecessor_data, predecessor_data + get_bins_per_state(), buffer);
+    apply_fired_effects(predecessor, op, buffer);
+    axiom_evaluator.evaluate(buffer, state_packer);
+}
+
+void StateRegistryBase::apply_fired_effects(
+    const GlobalState &predecessor, const OperatorProxy &op,
+    PackedStateBin *buffer) const {
+    /*
+      Conditions of effects refer to the predecessor, so we can collect the
+      effects first and then set all of them at once. The vector is
+      thread-local because ConcurrentStateRegistry computes successors of
+      several states at the same time.
+    */
+    static thread_local vector<FactPair> fired_effects;
+    fired_effects.clear();
+    for (EffectProxy effect : op.get_effects()) {
+        if (does_fire(effect, predecessor)) {
+            fired_effects.push_back(effect.get_fact().get_pair());
+        }
+    }
+    state_packer.apply_effects(buffer, fired_effects.data(), fired_effects.size());
+}
+
+void StateRegistryBase::copy_state_data(
+    const GlobalState &state, PackedStateBin *buffer) const {
+    const PackedStateBin *data = get_state_data(state);
+    copy(data, data + get_bins_per_state(), buffer);
+}
+
+void StateRegistryBase::pack_state_data(
+    const vector<int> &values, PackedStateBin *buffer) const {
+    // Avoid garbage values in half-full bins.
+    fill_n(buffer, get_bins_per_state(), 0);
+    for (int var = 0; var < num_variables; ++var) {
+        state_packer.set(buffer, var, values[var]);
+    }
+    axiom_evaluator.evaluate(buffer, state_packer);
+}
+
+int StateRegistryBase::get_state_size_in_bytes() const {
+    return get_bins_per_state() * sizeof(PackedStateBin);
+}
+
+
+StateRegistry::StateRegistry(
+    const TaskProxy &task_proxy, StateHashing state_hashing,
+    const shared_ptr<mapped_file_arena::MappedFileArena> &arena)
+    : StateRegistryBase(task_proxy),
+      state_hashing(state_hashing),
+      uses_state_data_pool(true),
+      state_data_pool(
+          get_bins_per_entry(),
+          mapped_file_arena::ArenaAllocator<PackedStateBin>(arena)),
+      scratch_buffer(get_bins_per_entry()),
       registered_states(
-          StateIDSemanticHash(state_data_pool, get_bins_per_state()),
-          StateIDSemanticEqual(state_data_pool, get_bins_per_state())),
-      cached_initial_state(0) {
+          StateIDSemanticHash(
+              StateDataAccessor(state_data_pool, scratch_buffer.data()),
+              get_bins_per_state(), state_hashing == StateHashing::ZOBRIST),
+          StateIDSemanticEqual(
+              StateDataAccessor(state_data_pool, scratch_buffer.data()),
+              get_bins_per_state())),
+      cached_initial_state(0),
+      num_generated_successors(0),
+      num_duplicate_successors(0) {
+    if (state_hashing == StateHashing::ZOBRIST) {
+        zobrist_keys.reserve(num_variables);
+        for (VariableProxy var : task_proxy.get_variables()) {
+            vector<HashType> keys;
+            keys.reserve(var.get_domain_size());
+            for (int value = 0; value < var.get_domain_size(); ++value) {
+                utils::HashState hash_state;
+                hash_state.feed(var.get_id());
+                hash_state.feed(value);
+                keys.push_back(get_hash(hash_state));
+            }
+            zobrist_keys.push_back(move(keys));
+            if (var.is_derived()) {
+                derived_variables.push_back(var.get_id());
+            }
+        }
+    }
 }
 
+StateRegistry::StateRegistry(
+    const TaskProxy &task_proxy, bool uses_state_data_pool,
+    bool has_compressed_states)
+    : StateRegistryBase(task_proxy, has_compressed_states),
+      state_hashing(StateHashing::PACKED_DATA),
+      uses_state_data_pool(uses_state_data_pool),
+      state_data_pool(get_bins_per_entry()),
+      scratch_buffer(get_bins_per_entry()),
+      registered_states(
+          StateIDSemanticHash(
+              StateDataAccessor(state_data_pool, scratch_buffer.data()),
+              get_bins_per_state(), false),
+          StateIDSemanticEqual(
+              StateDataAccessor(state_data_pool, scratch_buffer.data()),
+              get_bins_per_state())),
+      cached_initial_state(0),
+      num_generated_successors(0),
+      num_duplicate_successors(0) {
+}
 
 StateRegistry::~StateRegistry() {
     delete cached_initial_state;
 }
 
-StateID StateRegistry::insert_id_or_pop_state() {
-    /*
-      Attempt to insert a StateID for the last state of state_data_pool
-      if none is present yet. If this fails (another entry for this state
-      is present), we have to remove the duplicate entry from the
-      state data pool.
-    */
-    StateID id(state_data_pool.size() - 1);
-    pair<int, bool> result = registered_states.insert(id.value);
-    bool is_new_entry = result.second;
-    if (!is_new_entry) {
-        state_data_pool.pop_back();
+StateID StateRegistry::insert_scratch_state() {
+    const PackedStateBin *buffer = scratch_buffer.data();
+    int num_bins = get_bins_per_state();
+    HashType hash;
+    if (state_hashing == StateHashing::ZOBRIST) {
+        hash = load_hash(buffer + num_bins);
+    } else {
+        hash = hash_state_data(buffer, num_bins);
+    }
+    StateID::value_type id = registered_states.find(SCRATCH_ID, hash);
+    if (id == -1) {
+        id = add_scratch_state_data();
+        bool is_new_entry = registered_states.insert(id, hash).second;
+        utils::unused_variable(is_new_entry);
+        assert(is_new_entry);
     }
-    assert(registered_states.size() == static_cast<int>(state_data_pool.size()));
-    return StateID(result.first);
+    assert(registered_states.size() == state_data_pool.size());
+    return StateID(id);
 }
 
-GlobalState StateRegistry::lookup_state(StateID id) const {
-    return GlobalState(state_data_pool[id.value], *this, id);
+StateID::value_type StateRegistry::add_scratch_state_data() {
+    StateID::value_type id = state_data_pool.size();
+    if (id == SCRATCH_ID) {
+        cerr << "State registry exceeded the maximum number of state IDs. "
+             << "Rebuild with USE_64_BIT_STATE_IDS to support more states."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    state_data_pool.push_back(scratch_buffer.data());
+    num_states.store(id + 1, memory_order_relaxed);
+    return id;
+}
+
+GlobalState StateRegistry::lookup_stored_state(StateID) const {
+    ABORT("lookup_stored_state() is only used by registries that do not "
+          "use state_data_pool");
+}
+
+GlobalState StateRegistry::register_initial_state() {
+    PackedStateBin *buffer = scratch_buffer.data();
+    pack_initial_state(buffer);
+    if (state_hashing == StateHashing::ZOBRIST) {
+        store_hash(buffer + get_bins_per_state(), compute_zobrist_hash(buffer));
+    }
+    return lookup_state(insert_scratch_state());
 }
 
 const GlobalState &StateRegistry::get_initial_state() {
     if (cached_initial_state == 0) {
-        PackedStateBin *buffer = new PackedStateBin[get_bins_per_state()];
-        // Avoid garbage values in half-full bins.
-        fill_n(buffer, get_bins_per_state(), 0);
-
-        State initial_state = task_proxy.get_initial_state();
-        for (size_t i = 0; i < initial_state.size(); ++i) {
-            state_packer.set(buffer, i, initial_state[i].get_value());
-        }
-        state_data_pool.push_back(buffer);
-        // buffer is copied by push_back
-        delete[] buffer;
-        StateID id = insert_id_or_pop_state();
-        cached_initial_state = new GlobalState(lookup_state(id));
+        cached_initial_state = new GlobalState(register_initial_state());
     }
     return *cached_initial_state;
 }
@@ -70,28 +213,116 @@ const GlobalState &StateRegistry::get_initial_state() {
 //     operating on state buffers (PackedStateBin *).
 GlobalState StateRegistry::get_successor_state(const GlobalState &predecessor, const OperatorProxy &op) {
     assert(!op.is_axiom());
-    state_data_pool.push_back(predecessor.get_packed_buffer());
-    PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
-    for (EffectProxy effect : op.get_effects()) {
-        if (does_fire(effect, predecessor)) {
-            FactPair effect_pair = effect.get_fact().get_pair();
-            state_packer.set(buffer, effect_pair.var, effect_pair.value);
+    assert(&predecessor.get_registry() == this);
+    const PackedStateBin *predecessor_data = predecessor.get_packed_buffer();
+    PackedStateBin *buffer = scratch_buffer.data();
+    copy(predecessor_data, predecessor_data + get_bins_per_entry(), buffer);
+    if (state_hashing == StateHashing::ZOBRIST) {
+        int num_bins = get_bins_per_state();
+        HashType hash = load_hash(buffer + num_bins);
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                int old_value = state_packer.get(buffer, effect_pair.var);
+                const vector<HashType> &keys = zobrist_keys[effect_pair.var];
+                hash ^= keys[old_value] ^ keys[effect_pair.value];
+                state_packer.set(buffer, effect_pair.var, effect_pair.value);
+            }
         }
+        axiom_evaluator.evaluate(buffer, state_packer);
+        for (int var : derived_variables) {
+            const vector<HashType> &keys = zobrist_keys[var];
+            hash ^= keys[predecessor[var]] ^ keys[state_packer.get(buffer, var)];
+        }
+        store_hash(buffer + num_bins, hash);
+    } else {
+        apply_fired_effects(predecessor, op, buffer);
+        axiom_evaluator.evaluate(buffer, state_packer);
     }
-    axiom_evaluator.evaluate(buffer, state_packer);
-    StateID id = insert_id_or_pop_state();
+    size_t num_states_before = size();
+    StateID id = insert_scratch_state();
+    count_successor(size() == num_states_before);
     return lookup_state(id);
 }
 
-int StateRegistry::get_bins_per_state() const {
-    return state_packer.get_num_bins();
+StateID StateRegistry::find_state(const PackedStateBin *buffer) {
+    int num_bins = get_bins_per_state();
+    copy(buffer, buffer + num_bins, scratch_buffer.begin());
+    HashType hash;
+    if (state_hashing == StateHashing::ZOBRIST) {
+        hash = compute_zobrist_hash(buffer);
+        store_hash(scratch_buffer.data() + num_bins, hash);
+    } else {
+        hash = hash_state_data(buffer, num_bins);
+    }
+    StateID::value_type id = registered_states.find(SCRATCH_ID, hash);
+    if (id == -1) {
+        return StateID::no_state;
+    }
+    return StateID(id);
 }
 
-int StateRegistry::get_state_size_in_bytes() const {
-    return get_bins_per_state() * sizeof(PackedStateBin);
+GlobalState StateRegistry::insert_state(const PackedStateBin *buffer) {
+    int num_bins = get_bins_per_state();
+    copy(buffer, buffer + num_bins, scratch_buffer.begin());
+    if (state_hashing == StateHashing::ZOBRIST) {
+        store_hash(scratch_buffer.data() + num_bins, compute_zobrist_hash(buffer));
+    }
+    StateID id = insert_scratch_state();
+    return lookup_state(id);
+}
+
+int StateRegistry::get_bins_per_entry() const {
+    if (state_hashing == StateHashing::ZOBRIST) {
+        return get_bins_per_state() + HASH_BINS;
+    }
+    return get_bins_per_state();
+}
+
+StateRegistry::HashType StateRegistry::compute_zobrist_hash(
+    const PackedStateBin *buffer) const {
+    HashType hash = 0;
+    for (int var = 0; var < num_variables; ++var) {
+        hash ^= zobrist_keys[var][state_packer.get(buffer, var)];
+    }
+    return hash;
+}
+
+void StateRegistry::print_successor_statistics() const {
+    utils::g_log << "Duplicate successor states: " << num_duplicate_successors
+                 << "/" << num_generated_successors;
+    if (num_generated_successors) {
+        utils::g_log << " = " << static_cast<double>(num_duplicate_successors) /
+            num_generated_successors;
+    }
+    utils::g_log << endl;
 }
 
 void StateRegistry::print_statistics() const {
     utils::g_log << "Number of registered states: " << size() << endl;
+    print_successor_statistics();
+    utils::g_log << "State data bytes per state: "
+                 << get_bins_per_entry() * sizeof(PackedStateBin) << endl;
     registered_states.print_statistics();
 }
+
+void add_state_hashing_option_to_parser(OptionParser &parser) {
+    vector<string> hashing_methods;
+    vector<string> hashing_methods_doc;
+    hashing_methods.push_back("packed_data");
+    hashing_methods_doc.push_back(
+        "hash the packed data of each state");
+    hashing_methods.push_back("zobrist");
+    hashing_methods_doc.push_back(
+        "XOR of per-fact keys, which is updated incrementally for the "
+        "effects of the operator that generated a state and stored next to "
+        "the state data. This avoids a pass over the complete state data "
+        "for each generated state at the cost of one bin per state (two bins "
+        "in builds with 64-bit state IDs)");
+    parser.add_enum_option<StateHashing>(
+        "state_hashing",
+        hashing_methods,
+        "Hash function used for detecting duplicate states.",
+        "packed_data",
+        hashing_methods_doc);
+}
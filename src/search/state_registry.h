@@ -6,13 +6,21 @@
 #include "global_state.h"
 #include "state_id.h"
 
+#include "algorithms/group_probing_int_hash_set.h"
 #include "algorithms/int_hash_set.h"
 #include "algorithms/int_packer.h"
+#include "algorithms/mapped_file_arena.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
 #include "utils/hash.h"
 
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional.hh>
 #include <set>
+#include <vector>
 
 /*
   Overview of classes relevant to storing and working with registered states.
@@ -40,7 +48,7 @@
     is why IDs are intended for long term storage (e.g. in open lists).
     Internally, a StateID is just an integer, so it is cheap to store and copy.
 
-  PackedStateBin (currently the same as unsigned int)
+  PackedStateBin (same as unsigned int or uint64_t, see IntPacker::Bin)
     The actual state data is internally represented as a PackedStateBin array.
     Each PackedStateBin can contain the values of multiple variables.
     To minimize allocation overhead, the implementation stores the data of many
@@ -50,6 +58,11 @@
 
   -------------
 
+  StateRegistryBase
+    The part of a state registry that GlobalStates and PerStateInformation
+    rely on: the task, the layout of the packed state data and the number
+    of registered states. None of its public methods are virtual.
+
   StateRegistry
     The StateRegistry allows to create states giving them an ID. IDs from
     different state registries must not be mixed.
@@ -61,8 +74,16 @@
     while avoiding dynamically allocating each state individually.
     The index within this vector corresponds to the ID of the state.
 
+  CompressedStateRegistry
+    A StateRegistry that stores states with tree compression to save memory
+    (see compressed_state_registry.h).
+
+  ConcurrentStateRegistry
+    A StateRegistryBase that can be shared by several threads which register
+    and look up states at the same time (see concurrent_state_registry.h).
+
   PerStateInformation<T>
-    Associates a value of type T with every state in a given StateRegistry.
+    Associates a value of type T with every state in a given StateRegistryBase.
     Can be thought of as a very compactly implemented map from GlobalState to T.
     References stay valid as long as the state registry exists. Memory usage is
     essentially the same as a vector<T> whose size is the number of states in
@@ -81,18 +102,20 @@
 
   Solution:
 
-    SearchNodeInfo
-      Remaining part of a search node besides the state that needs to be stored.
+    SearchNodeInfoLayout
+      Remaining part of a search node besides the state that needs to be
+      stored is packed into a few bytes (the search node info).
+      SearchNodeInfoLayout chooses how to pack it and accesses the fields.
 
     SearchNode
-      A SearchNode combines a StateID, a reference to a SearchNodeInfo and
-      OperatorCost. It is generated for easier access and not intended for long
+      A SearchNode combines a StateID, a pointer to a search node info and its
+      layout. It is generated for easier access and not intended for long
       term storage. The state data is only stored once an can be accessed
       through the StateID.
 
     SearchSpace
-      The SearchSpace uses PerStateInformation<SearchNodeInfo> to map StateIDs to
-      SearchNodeInfos. The open lists only have to store StateIDs which can be
+      The SearchSpace uses PerStateArray<uint8_t> to map StateIDs to search
+      node infos. The open lists only have to store StateIDs which can be
       used to look up a search node in the SearchSpace on demand.
 
   ---------------
@@ -108,66 +131,95 @@
     state and each landmark whether it was reached in this state.
 */
 
-class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
-    struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
-        int state_size;
-        StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
-            : state_data_pool(state_data_pool),
-              state_size(state_size) {
-        }
+namespace options {
+class OptionParser;
+}
 
-        int_hash_set::HashType operator()(int id) const {
-            const PackedStateBin *data = state_data_pool[id];
-            utils::HashState hash_state;
-            for (int i = 0; i < state_size; ++i) {
-                hash_state.feed(data[i]);
-            }
-            return hash_state.get_hash32();
-        }
-    };
-
-    struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
-        int state_size;
-        StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
-            : state_data_pool(state_data_pool),
-              state_size(state_size) {
-        }
+enum class StateHashing {
+    PACKED_DATA,
+    ZOBRIST
+};
 
-        bool operator()(int lhs, int rhs) const {
-            const PackedStateBin *lhs_data = state_data_pool[lhs];
-            const PackedStateBin *rhs_data = state_data_pool[rhs];
-            return std::equal(lhs_data, lhs_data + state_size, rhs_data);
-        }
-    };
+/*
+  Common base of StateRegistry and ConcurrentStateRegistry. GlobalStates and
+  PerStateInformation only use this part of a registry, so its public
+  methods are not virtual.
+*/
+class StateRegistryBase : public subscriber::SubscriberService<StateRegistryBase> {
+public:
+    // Hash values of states have the same width as state IDs.
+#ifdef USE_64_BIT_STATE_IDS
+    using HashType = uint64_t;
+#else
+    using HashType = int_hash_set::HashType;
+#endif
 
     /*
-      Hash set of StateIDs used to detect states that are already registered in
-      this registry and find their IDs. States are compared/hashed semantically,
-      i.e. the actual state data is compared, not the memory location.
+      Hash set of state IDs used for duplicate detection. Configure the
+      build with USE_GROUP_PROBING_HASH_SET to use GroupProbingIntHashSet
+      instead of IntHashSet.
     */
-    using StateIDSet = int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
-
+    template<typename Hasher, typename Equal>
+#ifdef USE_GROUP_PROBING_HASH_SET
+    using StateIDHashSet = int_hash_set::GroupProbingIntHashSet<
+        Hasher, Equal, StateID::value_type, HashType>;
+#else
+    using StateIDHashSet = int_hash_set::IntHashSet<
+        Hasher, Equal, StateID::value_type, HashType>;
+#endif
+protected:
     TaskProxy task_proxy;
     const int_packer::IntPacker &state_packer;
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
 
-    segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
-    StateIDSet registered_states;
+    /*
+      Number of registered states. It is atomic because several threads
+      register states in a ConcurrentStateRegistry. Sequential registries
+      only use relaxed loads and stores, which compile to plain moves.
+    */
+    std::atomic<StateID::value_type> num_states;
 
-    GlobalState *cached_initial_state;
+    /*
+      If true, the buffers of the GlobalStates of this registry hold
+      compressed data, which we expand with decompress_state_data().
+    */
+    const bool has_compressed_states;
+
+    explicit StateRegistryBase(
+        const TaskProxy &task_proxy, bool has_compressed_states = false);
+
+    /*
+      Return the packed data of the given state if has_compressed_states is
+      true. The data may be overwritten by the next call.
+    */
+    virtual const PackedStateBin *decompress_state_data(StateID id) const;
 
-    StateID insert_id_or_pop_state();
-    int get_bins_per_state() const;
+    // Return the packed data of a state of this registry.
+    const PackedStateBin *get_state_data(const GlobalState &state) const {
+        if (has_compressed_states) {
+            return decompress_state_data(state.get_id());
+        }
+        return state.get_packed_buffer();
+    }
+
+    // Write the packed data of the initial state into buffer.
+    void pack_initial_state(PackedStateBin *buffer) const;
+
+    /*
+      Write the packed data of the state that results from applying op to
+      predecessor into buffer. Evaluating the axioms is not thread-safe.
+    */
+    void write_successor_data(
+        const GlobalState &predecessor, const OperatorProxy &op,
+        PackedStateBin *buffer) const;
+
+    // Set the effects of op that fire in predecessor in buffer.
+    void apply_fired_effects(
+        const GlobalState &predecessor, const OperatorProxy &op,
+        PackedStateBin *buffer) const;
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
-    ~StateRegistry();
+    virtual ~StateRegistryBase() override = default;
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
@@ -181,36 +233,70 @@ public:
         return state_packer.get(buffer, var);
     }
 
+    int get_state_value(const GlobalState &state, int var) const {
+        return state_packer.get(get_state_data(state), var);
+    }
+
+    // Write the values of all variables in buffer to values.
+    void unpack_state_data(const PackedStateBin *buffer, int *values) const {
+        state_packer.unpack_all(buffer, values);
+    }
+
+    // Write the values of all variables of state to values.
+    void unpack_state(const GlobalState &state, int *values) const {
+        state_packer.unpack_all(get_state_data(state), values);
+    }
+
+    int get_bins_per_state() const {
+        return state_packer.get_num_bins();
+    }
+
+    int get_state_size_in_bytes() const;
+
     /*
-      Returns the state that was registered at the given ID. The ID must refer
-      to a state in this registry. Do not mix IDs from from different registries.
+      Hash value of packed state data as used for duplicate detection with
+      StateHashing::PACKED_DATA. States
+      with equal data have equal hash values in all registries of the same
+      task, so the value can also be used to distribute states among several
+      registries (see hda_search.h).
     */
-    GlobalState lookup_state(StateID id) const;
+    static HashType hash_state_data(
+        const PackedStateBin *data, int num_bins) {
+        utils::HashState hash_state;
+        for (int i = 0; i < num_bins; ++i) {
+            utils::feed(hash_state, data[i]);
+        }
+        return get_hash(hash_state);
+    }
+
+    // Return the hash value of hash_state with the width of HashType.
+    static HashType get_hash(utils::HashState &hash_state) {
+#ifdef USE_64_BIT_STATE_IDS
+        return hash_state.get_hash64();
+#else
+        return hash_state.get_hash32();
+#endif
+    }
 
     /*
-      Returns a reference to the initial state and registers it if this was not
-      done before. The result is cached internally so subsequent calls are cheap.
+      Copy the packed data of the given state into buffer.
     */
-    const GlobalState &get_initial_state();
+    void copy_state_data(const GlobalState &state, PackedStateBin *buffer) const;
 
     /*
-      Returns the state that results from applying op to predecessor and
-      registers it if this was not done before. This is an expensive operation
-      as it includes duplicate checking.
+      Write the packed data of the state with the given variable values into
+      buffer (which must hold get_bins_per_state() bins). The values of
+      derived variables are ignored and computed with the axioms instead.
     */
-    GlobalState get_successor_state(const GlobalState &predecessor, const OperatorProxy &op);
+    void pack_state_data(const std::vector<int> &values, PackedStateBin *buffer) const;
 
     /*
       Returns the number of states registered so far.
     */
     size_t size() const {
-        return registered_states.size();
+        return num_states.load(std::memory_order_relaxed);
     }
 
-    int get_state_size_in_bytes() const;
-
-    void print_statistics() const;
-
     class const_iterator : public std::iterator<
                                std::forward_iterator_tag, StateID> {
         /*
@@ -220,11 +306,11 @@ public:
           this, in which case we will add the missing methods.
         */
 
-        friend class StateRegistry;
-        const StateRegistry &registry;
+        friend class StateRegistryBase;
+        const StateRegistryBase &registry;
         StateID pos;
 
-        const_iterator(const StateRegistry &registry, size_t start)
+        const_iterator(const StateRegistryBase &registry, size_t start)
             : registry(registry), pos(start) {
             utils::unused_variable(this->registry);
         }
@@ -261,4 +347,259 @@ public:
     }
 };
 
+
+/*
+  The registry used by sequential searches. It stores the packed data of
+  all states in state_data_pool (indexed by state ID) and detects
+  duplicates with a hash set of state IDs.
+
+  Registries that store their states differently (CompressedStateRegistry,
+  BitstateStateRegistry) derive from this class, but the methods that
+  searches call for every state (lookup_state(), get_initial_state() and
+  size()) are not virtual. They handle the default case inline and only
+  call the protected virtual hooks of these registries otherwise.
+*/
+class StateRegistry : public StateRegistryBase {
+protected:
+    // Arrays of bins that are stored on the heap or in a MappedFileArena.
+    using StateDataPool = segmented_vector::SegmentedArrayVector<
+        PackedStateBin, mapped_file_arena::ArenaAllocator<PackedStateBin>>;
+private:
+    /*
+      Placeholder ID for the state data in the scratch buffer. It allows
+      looking up a state in registered_states before adding it to
+      state_data_pool, so duplicates never have to be added and removed.
+    */
+    static const StateID::value_type SCRATCH_ID =
+        std::numeric_limits<StateID::value_type>::max();
+
+    // Number of bins used to store a hash value with StateHashing::ZOBRIST.
+    static const int HASH_BINS =
+        (sizeof(HashType) + sizeof(PackedStateBin) - 1) / sizeof(PackedStateBin);
+
+    struct StateDataAccessor {
+        const StateDataPool &state_data_pool;
+        const PackedStateBin *scratch_data;
+        StateDataAccessor(
+            const StateDataPool &state_data_pool,
+            const PackedStateBin *scratch_data)
+            : state_data_pool(state_data_pool),
+              scratch_data(scratch_data) {
+        }
+
+        const PackedStateBin *operator[](StateID::value_type id) const {
+            if (id == SCRATCH_ID) {
+                return scratch_data;
+            }
+            return state_data_pool[id];
+        }
+    };
+
+    struct StateIDSemanticHash {
+        StateDataAccessor state_data;
+        int state_size;
+        // If true, the hash value is stored in the bins after the state data.
+        bool use_stored_hash;
+        StateIDSemanticHash(
+            const StateDataAccessor &state_data, int state_size,
+            bool use_stored_hash)
+            : state_data(state_data),
+              state_size(state_size),
+              use_stored_hash(use_stored_hash) {
+        }
+
+        HashType operator()(StateID::value_type id) const {
+            const PackedStateBin *data = state_data[id];
+            if (use_stored_hash) {
+                return StateRegistry::load_hash(data + state_size);
+            }
+            return StateRegistry::hash_state_data(data, state_size);
+        }
+    };
+
+    struct StateIDSemanticEqual {
+        StateDataAccessor state_data;
+        int state_size;
+        StateIDSemanticEqual(const StateDataAccessor &state_data, int state_size)
+            : state_data(state_data),
+              state_size(state_size) {
+        }
+
+        bool operator()(StateID::value_type lhs, StateID::value_type rhs) const {
+            const PackedStateBin *lhs_data = state_data[lhs];
+            const PackedStateBin *rhs_data = state_data[rhs];
+            return std::equal(lhs_data, lhs_data + state_size, rhs_data);
+        }
+    };
+
+    /*
+      Hash set of StateIDs used to detect states that are already registered in
+      this registry and find their IDs. States are compared/hashed semantically,
+      i.e. the actual state data is compared, not the memory location.
+    */
+    using StateIDSet = StateIDHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
+
+    const StateHashing state_hashing;
+    // False for subclasses that do not use state_data_pool and the hash set.
+    const bool uses_state_data_pool;
+
+    /*
+      With Zobrist hashing, the hash value of a state is the XOR of the keys
+      of its facts, and we store it in HASH_BINS additional bins after the
+      state data. Successor hashes are then updated incrementally from the hash of
+      the predecessor.
+    */
+    std::vector<std::vector<HashType>> zobrist_keys;
+    std::vector<int> derived_variables;
+
+    StateDataPool state_data_pool;
+    // New states are built here (including the stored hash, if any).
+    std::vector<PackedStateBin> scratch_buffer;
+    StateIDSet registered_states;
+
+    GlobalState *cached_initial_state;
+
+    long long num_generated_successors;
+    long long num_duplicate_successors;
+
+    /*
+      Return the ID of the state in the scratch buffer. If the state is not
+      registered yet, add it to state_data_pool.
+    */
+    StateID insert_scratch_state();
+
+    // Add the state in the scratch buffer to state_data_pool.
+    StateID::value_type add_scratch_state_data();
+
+    // Number of bins stored for each state, including the stored hash.
+    int get_bins_per_entry() const;
+    HashType compute_zobrist_hash(const PackedStateBin *buffer) const;
+
+    static HashType load_hash(const PackedStateBin *bins) {
+        HashType hash;
+        std::memcpy(&hash, bins, sizeof(HashType));
+        return hash;
+    }
+
+    static void store_hash(PackedStateBin *bins, HashType hash) {
+        std::memcpy(bins, &hash, sizeof(HashType));
+    }
+protected:
+    /*
+      Constructor for subclasses that store their states themselves. They
+      must override lookup_stored_state() and register_initial_state().
+    */
+    StateRegistry(
+        const TaskProxy &task_proxy, bool uses_state_data_pool,
+        bool has_compressed_states);
+
+    // Return the state with the given ID if uses_state_data_pool is false.
+    virtual GlobalState lookup_stored_state(StateID id) const;
+
+    // Register the initial state. Only called once.
+    virtual GlobalState register_initial_state();
+
+    // Count a successor generated by get_successor_state().
+    void count_successor(bool is_duplicate) {
+        ++num_generated_successors;
+        if (is_duplicate) {
+            ++num_duplicate_successors;
+        }
+    }
+    void print_successor_statistics() const;
+public:
+    /*
+      If arena is given, the state data is stored in the memory-mapped
+      file of the arena instead of on the heap.
+    */
+    explicit StateRegistry(
+        const TaskProxy &task_proxy,
+        StateHashing state_hashing = StateHashing::PACKED_DATA,
+        const std::shared_ptr<mapped_file_arena::MappedFileArena> &arena = nullptr);
+    virtual ~StateRegistry() override;
+
+    /*
+      Returns the state that was registered at the given ID. The ID must refer
+      to a state in this registry. Do not mix IDs from from different registries.
+    */
+    GlobalState lookup_state(StateID id) const {
+        if (uses_state_data_pool) {
+            return GlobalState(state_data_pool[id.value], *this, id);
+        }
+        return lookup_stored_state(id);
+    }
+
+    /*
+      Returns a reference to the initial state and registers it if this was not
+      done before. The result is cached internally so subsequent calls are cheap.
+    */
+    const GlobalState &get_initial_state();
+
+    /*
+      Returns the state that results from applying op to predecessor and
+      registers it if this was not done before. This is an expensive operation
+      as it includes duplicate checking.
+    */
+    virtual GlobalState get_successor_state(
+        const GlobalState &predecessor, const OperatorProxy &op);
+
+    /*
+      Like get_successor_state(), but registries that detect duplicates
+      approximately (see BitstateStateRegistry) may return tl::nullopt
+      instead of registering the state. The search must then treat the
+      successor as a duplicate that it has seen before.
+    */
+    virtual tl::optional<GlobalState> try_get_successor_state(
+        const GlobalState &predecessor, const OperatorProxy &op) {
+        return get_successor_state(predecessor, op);
+    }
+
+    /*
+      Registries that only keep the data of the states that the search
+      still needs (see BitstateStateRegistry) count references to their
+      states. Every registered state starts with one reference. Once all
+      references are released, the data of the state is recycled and the
+      state must not be looked up anymore. The default registry keeps all
+      states, so it ignores these calls.
+    */
+    virtual void retain_state(StateID /*id*/) {
+    }
+
+    virtual void release_state(StateID /*id*/) {
+    }
+
+    virtual bool is_released(StateID /*id*/) const {
+        return false;
+    }
+
+    /*
+      Write the packed data of the state that results from applying op to
+      predecessor into buffer (which must hold get_bins_per_state() bins)
+      without registering the state.
+    */
+    void compute_successor_data(
+        const GlobalState &predecessor, const OperatorProxy &op,
+        PackedStateBin *buffer) const {
+        write_successor_data(predecessor, op, buffer);
+    }
+
+    /*
+      Returns the ID of the state with the given packed data if it is
+      registered and StateID::no_state otherwise. Unlike insert_state(),
+      this never registers the state.
+    */
+    virtual StateID find_state(const PackedStateBin *buffer);
+
+    /*
+      Returns the state with the given packed data and registers it if this
+      was not done before. The data must have been created by a registry for
+      the same task, e.g. with compute_successor_data().
+    */
+    virtual GlobalState insert_state(const PackedStateBin *buffer);
+
+    virtual void print_statistics() const;
+};
+
+extern void add_state_hashing_option_to_parser(options::OptionParser &parser);
+
 #endif
@@ -0,0 +1,75 @@
+#include "novelty_table.h"
+
+#include "../task_proxy.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace novelty_table {
+static int compute_num_facts(const TaskProxy &task_proxy) {
+    int num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        num_facts += var.get_domain_size();
+    }
+    return num_facts;
+}
+
+static size_t get_num_fact_pairs(int width, int num_facts) {
+    if (width < 2) {
+        return 0;
+    }
+    return static_cast<size_t>(num_facts) * (num_facts - 1) / 2;
+}
+
+NoveltyTable::NoveltyTable(const TaskProxy &task_proxy, int width)
+    : width(width),
+      seen_facts(compute_num_facts(task_proxy)),
+      seen_fact_pairs(get_num_fact_pairs(width, compute_num_facts(task_proxy))),
+      fact_ids(task_proxy.get_variables().size()) {
+    assert(width == 1 || width == 2);
+    int num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+    }
+}
+
+int NoveltyTable::compute_novelty_and_update(const vector<int> &values) {
+    int num_variables = values.size();
+    bool has_new_fact = false;
+    for (int var = 0; var < num_variables; ++var) {
+        int fact_id = fact_offsets[var] + values[var];
+        fact_ids[var] = fact_id;
+        if (!seen_facts.test(fact_id)) {
+            seen_facts.set(fact_id);
+            has_new_fact = true;
+        }
+    }
+    if (width == 1) {
+        return has_new_fact ? 1 : 2;
+    }
+
+    /*
+      Fact IDs increase with the variable, so fact_ids[var] is the larger
+      fact of all pairs with the facts of the previous variables.
+    */
+    bool has_new_pair = false;
+    for (int var = 1; var < num_variables; ++var) {
+        size_t row = static_cast<size_t>(fact_ids[var]) * (fact_ids[var] - 1) / 2;
+        for (int other_var = 0; other_var < var; ++other_var) {
+            size_t pos = row + fact_ids[other_var];
+            if (!seen_fact_pairs.test(pos)) {
+                seen_fact_pairs.set(pos);
+                has_new_pair = true;
+            }
+        }
+    }
+    if (has_new_fact) {
+        return 1;
+    } else if (has_new_pair) {
+        return 2;
+    }
+    return 3;
+}
+}
@@ -0,0 +1,46 @@
+#ifndef TASK_UTILS_NOVELTY_TABLE_H
+#define TASK_UTILS_NOVELTY_TABLE_H
+
+#include "../algorithms/dynamic_bitset.h"
+
+#include <vector>
+
+class TaskProxy;
+
+namespace novelty_table {
+/*
+  Remember which facts (width 1) and fact pairs (width 2) occurred in
+  the states seen so far.
+
+  The novelty of a state is the size of the smallest tuple of facts that
+  no earlier state contained: 1 if it contains a new fact, 2 if it
+  contains a new pair of facts (only with width 2) and width + 1
+  otherwise.
+
+  The facts are numbered consecutively by variable and value. Fact pairs
+  (a, b) with a < b use bit b * (b - 1) / 2 + a of a triangular bitset,
+  so all pairs of a state with fact b as the larger fact lie in one row.
+  The table for width 2 needs n * (n - 1) / 2 bits for n facts.
+*/
+class NoveltyTable {
+    const int width;
+    std::vector<int> fact_offsets;
+    dynamic_bitset::DynamicBitset<> seen_facts;
+    dynamic_bitset::DynamicBitset<> seen_fact_pairs;
+    std::vector<int> fact_ids;
+public:
+    NoveltyTable(const TaskProxy &task_proxy, int width);
+
+    /*
+      Compute the novelty of the state with the given values and mark its
+      facts and fact pairs as seen.
+    */
+    int compute_novelty_and_update(const std::vector<int> &values);
+
+    int get_width() const {
+        return width;
+    }
+};
+}
+
+#endif
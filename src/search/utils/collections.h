@@ -36,6 +36,11 @@ bool in_bounds(long index, const T &container) {
     return index >= 0 && static_cast<size_t>(index) < container.size();
 }
 
+template<class T>
+bool in_bounds(long long index, const T &container) {
+    return index >= 0 && static_cast<size_t>(index) < container.size();
+}
+
 template<class T>
 bool in_bounds(size_t index, const T &container) {
     return index < container.size();
@@ -1,6 +1,7 @@
 #ifndef UTILS_HASH_H
 #define UTILS_HASH_H
 
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -243,6 +244,13 @@ void feed(HashState &hash_state, const std::pair<T1, T2> &p) {
     feed(hash_state, p.second);
 }
 
+template<typename T, std::size_t N>
+void feed(HashState &hash_state, const std::array<T, N> &arr) {
+    for (const T &item : arr) {
+        feed(hash_state, item);
+    }
+}
+
 template<typename T>
 void feed(HashState &hash_state, const std::vector<T> &vec) {
     /*